@@ -0,0 +1,189 @@
+#include "epoch.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Reader state: (epoch << 1) | 1 inside a read section, 0 outside
+#define EPOCH_ACTIVE 1
+
+// Per-thread reader record (owned by one thread, listed in its domain)
+struct EpochRecord {
+    EpochDomain* domain;            // Owning domain
+    EpochRecord* prev;              // Domain's record list
+    EpochRecord* next;
+    _Atomic uint64_t state;         // Written by the owner, read by writers advancing
+    unsigned depth;                 // Read section nesting (owner only)
+};
+
+// Unregister a thread's record when the thread exits
+static void epoch_record_retire(void* arg) {
+    EpochRecord* record = arg;
+    EpochDomain* domain = record->domain;
+
+    pthread_mutex_lock(&domain->lock);
+    if (record->prev) record->prev->next = record->next;
+    else domain->records = record->next;
+    if (record->next) record->next->prev = record->prev;
+    pthread_mutex_unlock(&domain->lock);
+
+    free(record);
+}
+
+// This thread's record, registered on first use
+static EpochRecord* epoch_record(EpochDomain* domain) {
+    EpochRecord* record = pthread_getspecific(domain->key);
+    if (record) return record;
+
+    record = calloc(1, sizeof(EpochRecord));
+    if (!record) return NULL;
+    record->domain = domain;
+    atomic_init(&record->state, 0);
+
+    if (pthread_setspecific(domain->key, record) != 0) {
+        free(record);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&domain->lock);
+    record->next = domain->records;
+    if (domain->records) domain->records->prev = record;
+    domain->records = record;
+    pthread_mutex_unlock(&domain->lock);
+    return record;
+}
+
+// Move to the next epoch if every active reader has seen the current one (lock held)
+static void epoch_advance(EpochDomain* domain) {
+    atomic_thread_fence(memory_order_seq_cst);
+
+    uint64_t epoch = atomic_load(&domain->global);
+    if (atomic_load(&domain->anonymous) > 0) return;
+
+    for (EpochRecord* record = domain->records; record; record = record->next) {
+        uint64_t state = atomic_load(&record->state);
+        if ((state & EPOCH_ACTIVE) && (state >> 1) != epoch) return;
+    }
+
+    atomic_store(&domain->global, epoch + 1);
+}
+
+// Run and drop a list of retired entries
+static void epoch_release(EpochEntry* entry) {
+    while (entry) {
+        EpochEntry* next = entry->next;
+        entry->release(entry, entry->context);
+        entry = next;
+    }
+}
+
+bool epoch_init(EpochDomain* domain) {
+    if (!domain) return false;
+
+    memset(domain, 0, sizeof(EpochDomain));
+    atomic_init(&domain->global, 1);
+    atomic_init(&domain->anonymous, 0);
+
+    if (pthread_key_create(&domain->key, epoch_record_retire) != 0) return false;
+    pthread_mutex_init(&domain->lock, NULL);
+    return true;
+}
+
+// Free everything still retired; no thread may be reading any more
+void epoch_destroy(EpochDomain* domain) {
+    if (!domain || !atomic_load(&domain->global)) return;
+
+    pthread_key_delete(domain->key);
+
+    epoch_release(domain->retired_head);
+    domain->retired_head = NULL;
+    domain->retired_tail = NULL;
+
+    while (domain->records) {
+        EpochRecord* record = domain->records;
+        domain->records = record->next;
+        free(record);
+    }
+
+    pthread_mutex_destroy(&domain->lock);
+    memset(domain, 0, sizeof(EpochDomain));
+}
+
+// Begin a read section; objects reachable now stay valid until epoch_exit
+void epoch_enter(EpochDomain* domain) {
+    EpochRecord* record = epoch_record(domain);
+    if (!record) {
+        // No record for this thread: hold every epoch back instead
+        atomic_fetch_add(&domain->anonymous, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        return;
+    }
+
+    if (record->depth++ == 0) {
+        uint64_t epoch = atomic_load_explicit(&domain->global, memory_order_relaxed);
+        atomic_store_explicit(&record->state, (epoch << 1) | EPOCH_ACTIVE, memory_order_relaxed);
+
+        // Publish the state before any shared pointer is loaded
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+}
+
+// End a read section
+void epoch_exit(EpochDomain* domain) {
+    EpochRecord* record = pthread_getspecific(domain->key);
+    if (!record) {
+        atomic_fetch_sub_explicit(&domain->anonymous, 1, memory_order_release);
+        return;
+    }
+
+    if (--record->depth == 0) {
+        atomic_store_explicit(&record->state, 0, memory_order_release);
+    }
+}
+
+// Free an unlinked object once every reader that might hold it has left
+void epoch_retire(EpochDomain* domain, EpochEntry* entry, EpochFree release, void* context) {
+    entry->next = NULL;
+    entry->release = release;
+    entry->context = context;
+
+    pthread_mutex_lock(&domain->lock);
+
+    entry->epoch = atomic_load(&domain->global);
+    if (domain->retired_tail) domain->retired_tail->next = entry;
+    else domain->retired_head = entry;
+    domain->retired_tail = entry;
+
+    bool due = ++domain->retired_count >= EPOCH_RECLAIM_BATCH;
+    pthread_mutex_unlock(&domain->lock);
+
+    if (due) {
+        epoch_reclaim(domain);
+    }
+}
+
+// Advance the epoch if possible and free what is now unreachable
+void epoch_reclaim(EpochDomain* domain) {
+    pthread_mutex_lock(&domain->lock);
+
+    epoch_advance(domain);
+    uint64_t epoch = atomic_load(&domain->global);
+
+    // Objects retired two epochs back predate every active reader
+    EpochEntry* ready = domain->retired_head;
+    EpochEntry* last = NULL;
+    for (EpochEntry* entry = ready; entry && entry->epoch + 2 <= epoch; entry = entry->next) {
+        last = entry;
+        domain->retired_count--;
+    }
+
+    if (last) {
+        domain->retired_head = last->next;
+        if (!domain->retired_head) domain->retired_tail = NULL;
+        last->next = NULL;
+    } else {
+        ready = NULL;
+    }
+
+    pthread_mutex_unlock(&domain->lock);
+    epoch_release(ready);
+}
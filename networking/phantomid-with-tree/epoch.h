@@ -0,0 +1,50 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Epoch Constants
+#define EPOCH_RECLAIM_BATCH 64      // Pending objects that trigger a reclaim pass
+
+typedef struct EpochEntry EpochEntry;
+
+// Releases a retired object once no reader can reach it
+typedef void (*EpochFree)(EpochEntry* entry, void* context);
+
+// Deferred free, embedded in the retired object
+struct EpochEntry {
+    EpochEntry* next;               // Retired list
+    uint64_t epoch;                 // Global epoch when retired
+    EpochFree release;              // Release callback
+    void* context;                  // Callback argument
+};
+
+// Per-thread reader record
+typedef struct EpochRecord EpochRecord;
+
+// Epoch-based reclamation domain: readers run without locks, writers retire
+// what they unlink and it is freed two epochs later
+typedef struct {
+    _Atomic uint64_t global;        // Current epoch
+    _Atomic size_t anonymous;       // Readers that could not get a record (block advancing)
+    pthread_key_t key;              // This thread's EpochRecord
+    pthread_mutex_t lock;           // Guards everything below
+    EpochRecord* records;           // Registered reader threads
+    EpochEntry* retired_head;       // Retired objects, oldest first
+    EpochEntry* retired_tail;
+    size_t retired_count;
+} EpochDomain;
+
+// Epoch Functions
+bool epoch_init(EpochDomain* domain);
+void epoch_destroy(EpochDomain* domain);
+void epoch_enter(EpochDomain* domain);
+void epoch_exit(EpochDomain* domain);
+void epoch_retire(EpochDomain* domain, EpochEntry* entry, EpochFree release, void* context);
+void epoch_reclaim(EpochDomain* domain);
+
+#endif // EPOCH_H
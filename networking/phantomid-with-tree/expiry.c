@@ -0,0 +1,123 @@
+#include "expiry.h"
+
+#include <stdlib.h>
+
+// Put an entry at a slot and tell its timer
+static void expiry_place(ExpiryHeap* heap, size_t slot, ExpiryEntry entry) {
+    heap->entries[slot] = entry;
+    entry.timer->slot = slot;
+}
+
+static void expiry_sift_up(ExpiryHeap* heap, size_t slot) {
+    ExpiryEntry entry = heap->entries[slot];
+
+    while (slot > 0) {
+        size_t parent = (slot - 1) / EXPIRY_ARITY;
+        if (heap->entries[parent].deadline <= entry.deadline) break;
+        expiry_place(heap, slot, heap->entries[parent]);
+        slot = parent;
+    }
+    expiry_place(heap, slot, entry);
+}
+
+static void expiry_sift_down(ExpiryHeap* heap, size_t slot) {
+    ExpiryEntry entry = heap->entries[slot];
+
+    for (;;) {
+        size_t first = slot * EXPIRY_ARITY + 1;
+        if (first >= heap->count) break;
+
+        size_t last = first + EXPIRY_ARITY < heap->count ? first + EXPIRY_ARITY : heap->count;
+        size_t earliest = first;
+        for (size_t child = first + 1; child < last; child++) {
+            if (heap->entries[child].deadline < heap->entries[earliest].deadline) earliest = child;
+        }
+        if (entry.deadline <= heap->entries[earliest].deadline) break;
+
+        expiry_place(heap, slot, heap->entries[earliest]);
+        slot = earliest;
+    }
+    expiry_place(heap, slot, entry);
+}
+
+// Remove the entry at a slot, filling the hole with the last entry
+static void expiry_remove_slot(ExpiryHeap* heap, size_t slot) {
+    heap->entries[slot].timer->slot = EXPIRY_IDLE;
+    heap->count--;
+    if (slot == heap->count) return;
+
+    ExpiryTimer* moved = heap->entries[heap->count].timer;
+    heap->entries[slot] = heap->entries[heap->count];
+    expiry_sift_down(heap, slot);
+    expiry_sift_up(heap, moved->slot);
+}
+
+void expiry_init(ExpiryHeap* heap) {
+    heap->entries = NULL;
+    heap->count = 0;
+    heap->capacity = 0;
+}
+
+void expiry_destroy(ExpiryHeap* heap) {
+    for (size_t i = 0; i < heap->count; i++) {
+        heap->entries[i].timer->slot = EXPIRY_IDLE;
+    }
+    free(heap->entries);
+    expiry_init(heap);
+}
+
+void expiry_timer_init(ExpiryTimer* timer) {
+    timer->slot = EXPIRY_IDLE;
+}
+
+// Make room for count scheduled timers so later schedules cannot fail
+bool expiry_reserve(ExpiryHeap* heap, size_t count) {
+    if (count <= heap->capacity) return true;
+
+    size_t capacity = heap->capacity ? heap->capacity : EXPIRY_HEAP_INITIAL;
+    while (capacity < count) capacity *= 2;
+
+    ExpiryEntry* entries = realloc(heap->entries, capacity * sizeof(ExpiryEntry));
+    if (!entries) return false;
+    heap->entries = entries;
+    heap->capacity = capacity;
+    return true;
+}
+
+// Schedule a timer, or move it if it is already scheduled
+bool expiry_schedule(ExpiryHeap* heap, ExpiryTimer* timer, uint64_t deadline) {
+    if (timer->slot != EXPIRY_IDLE) {
+        heap->entries[timer->slot].deadline = deadline;
+        expiry_sift_down(heap, timer->slot);
+        expiry_sift_up(heap, timer->slot);
+        return true;
+    }
+
+    if (!expiry_reserve(heap, heap->count + 1)) return false;
+    heap->entries[heap->count] = (ExpiryEntry){ .deadline = deadline, .timer = timer };
+    expiry_sift_up(heap, heap->count++);
+    return true;
+}
+
+// Unschedule a timer (no-op if it is idle)
+void expiry_cancel(ExpiryHeap* heap, ExpiryTimer* timer) {
+    if (timer->slot != EXPIRY_IDLE) expiry_remove_slot(heap, timer->slot);
+}
+
+// Remove and return the earliest timer due at now, NULL if none is
+ExpiryTimer* expiry_pop(ExpiryHeap* heap, uint64_t now) {
+    if (heap->count == 0 || heap->entries[0].deadline > now) return NULL;
+
+    ExpiryTimer* timer = heap->entries[0].timer;
+    expiry_remove_slot(heap, 0);
+    return timer;
+}
+
+// Earliest deadline, EXPIRY_NEVER when nothing is scheduled
+uint64_t expiry_next(const ExpiryHeap* heap) {
+    return heap->count > 0 ? heap->entries[0].deadline : EXPIRY_NEVER;
+}
+
+size_t expiry_count(const ExpiryHeap* heap) {
+    return heap->count;
+}
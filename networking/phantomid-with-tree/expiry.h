@@ -0,0 +1,43 @@
+#ifndef EXPIRY_H
+#define EXPIRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Expiry Constants
+#define EXPIRY_HEAP_INITIAL 1024    // Initial heap slots (grows by doubling)
+#define EXPIRY_ARITY 4              // Children per heap entry (one cache line of entries)
+#define EXPIRY_IDLE SIZE_MAX        // Slot of a timer that is not scheduled
+#define EXPIRY_NEVER UINT64_MAX     // Next deadline of an empty heap
+
+// Timer embedded in the object that expires
+typedef struct {
+    size_t slot;                    // Heap position (EXPIRY_IDLE when not scheduled)
+} ExpiryTimer;
+
+// Heap entry: the deadline sits next to its timer so sifting only touches the heap
+typedef struct {
+    uint64_t deadline;
+    ExpiryTimer* timer;
+} ExpiryEntry;
+
+// Min-heap of deadlines (callers serialize all access)
+typedef struct {
+    ExpiryEntry* entries;
+    size_t count;
+    size_t capacity;
+} ExpiryHeap;
+
+// Expiry Functions
+void expiry_init(ExpiryHeap* heap);
+void expiry_destroy(ExpiryHeap* heap);
+void expiry_timer_init(ExpiryTimer* timer);
+bool expiry_reserve(ExpiryHeap* heap, size_t count);
+bool expiry_schedule(ExpiryHeap* heap, ExpiryTimer* timer, uint64_t deadline);
+void expiry_cancel(ExpiryHeap* heap, ExpiryTimer* timer);
+ExpiryTimer* expiry_pop(ExpiryHeap* heap, uint64_t now);
+uint64_t expiry_next(const ExpiryHeap* heap);
+size_t expiry_count(const ExpiryHeap* heap);
+
+#endif // EXPIRY_H
@@ -0,0 +1,144 @@
+#include "flat.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Resize every column to capacity slots (columns already grown stay grown on failure)
+static bool flat_reserve(FlatTree* flat, uint32_t capacity) {
+    void* column;
+
+#define FLAT_GROW(field) \
+    column = realloc(flat->field, (size_t)capacity * sizeof(*flat->field)); \
+    if (!column) return false; \
+    flat->field = column;
+
+    FLAT_GROW(parent)
+    FLAT_GROW(first_child)
+    FLAT_GROW(next_sibling)
+    FLAT_GROW(last_child)
+    FLAT_GROW(flags)
+    FLAT_GROW(id)
+    FLAT_GROW(created)
+    FLAT_GROW(expires)
+
+#undef FLAT_GROW
+
+    flat->capacity = capacity;
+    return true;
+}
+
+bool flat_init(FlatTree* flat, uint32_t capacity) {
+    if (!flat) return false;
+
+    memset(flat, 0, sizeof(FlatTree));
+    if (!flat_reserve(flat, capacity > 0 ? capacity : FLAT_INITIAL)) {
+        flat_destroy(flat);
+        return false;
+    }
+    return true;
+}
+
+void flat_destroy(FlatTree* flat) {
+    if (!flat) return;
+
+    free(flat->parent);
+    free(flat->first_child);
+    free(flat->next_sibling);
+    free(flat->last_child);
+    free(flat->flags);
+    free(flat->id);
+    free(flat->created);
+    free(flat->expires);
+    memset(flat, 0, sizeof(FlatTree));
+}
+
+// Drop every node, keeping the columns for reuse
+void flat_clear(FlatTree* flat) {
+    flat->count = 0;
+}
+
+// Add a node as the last child of parent (FLAT_NONE for the root); parents
+// come before their children. Returns the new index or FLAT_NONE.
+uint32_t flat_append(FlatTree* flat, uint32_t parent, const uint8_t* id, uint8_t flags,
+                     uint64_t created, uint64_t expires) {
+    if (parent != FLAT_NONE && parent >= flat->count) return FLAT_NONE;
+
+    if (flat->count == flat->capacity) {
+        if (flat->capacity > UINT32_MAX / 2 || !flat_reserve(flat, flat->capacity * 2)) {
+            return FLAT_NONE;
+        }
+    }
+
+    uint32_t index = flat->count++;
+    flat->parent[index] = parent;
+    flat->first_child[index] = FLAT_NONE;
+    flat->next_sibling[index] = FLAT_NONE;
+    flat->last_child[index] = FLAT_NONE;
+    flat->flags[index] = flags;
+    memcpy(flat->id[index], id, FLAT_ID_BYTES);
+    flat->created[index] = created;
+    flat->expires[index] = expires;
+
+    if (parent != FLAT_NONE) {
+        if (flat->last_child[parent] == FLAT_NONE) {
+            flat->first_child[parent] = index;
+        } else {
+            flat->next_sibling[flat->last_child[parent]] = index;
+        }
+        flat->last_child[parent] = index;
+    }
+    return index;
+}
+
+// Column bytes per node
+size_t flat_node_bytes(void) {
+    return 4 * sizeof(uint32_t) + sizeof(uint8_t) + FLAT_ID_BYTES + 2 * sizeof(uint64_t);
+}
+
+// Pre-order walk of every tree in the store without a stack: down to the
+// first child, else across to the next sibling, else up until one has one.
+// Nodes appended in pre-order are visited in index order.
+void flat_dfs(const FlatTree* flat, FlatVisitor visitor, void* user_data) {
+    for (uint32_t root = 0; root < flat->count; root++) {
+        if (flat->parent[root] != FLAT_NONE) continue;
+
+        uint32_t node = root;
+        while (node != FLAT_NONE) {
+            visitor(flat, node, user_data);
+
+            if (flat->first_child[node] != FLAT_NONE) {
+                node = flat->first_child[node];
+                continue;
+            }
+            while (node != root && flat->next_sibling[node] == FLAT_NONE) {
+                node = flat->parent[node];
+            }
+            node = node == root ? FLAT_NONE : flat->next_sibling[node];
+        }
+    }
+}
+
+// Level-order walk (every node is queued once, so the queue is a flat array)
+bool flat_bfs(const FlatTree* flat, FlatVisitor visitor, void* user_data) {
+    if (flat->count == 0) return true;
+
+    uint32_t* queue = malloc((size_t)flat->count * sizeof(uint32_t));
+    if (!queue) return false;
+
+    uint32_t tail = 0;
+    for (uint32_t root = 0; root < flat->count; root++) {
+        if (flat->parent[root] == FLAT_NONE) queue[tail++] = root;
+    }
+
+    for (uint32_t head = 0; head < tail; head++) {
+        uint32_t node = queue[head];
+        visitor(flat, node, user_data);
+
+        for (uint32_t child = flat->first_child[node]; child != FLAT_NONE; child = flat->next_sibling[child]) {
+            queue[tail++] = child;
+        }
+    }
+
+    free(queue);
+    return true;
+}
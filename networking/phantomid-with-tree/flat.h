@@ -0,0 +1,41 @@
+#ifndef FLAT_H
+#define FLAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Flat Constants
+#define FLAT_NONE UINT32_MAX        // No node (root's parent, end of a sibling list)
+#define FLAT_ID_BYTES 32            // Binary account ID
+#define FLAT_INITIAL 1024           // Initial column capacity (grows by doubling)
+
+// Flat tree: one column per field, nodes addressed by 32-bit index. Nodes
+// appended in pre-order make index order the DFS order.
+typedef struct {
+    uint32_t count;                 // Nodes stored
+    uint32_t capacity;              // Slots per column
+    uint32_t* parent;               // Parent index (FLAT_NONE for the root)
+    uint32_t* first_child;          // First child index
+    uint32_t* next_sibling;         // Next child of the same parent
+    uint32_t* last_child;           // Last child (appends in O(1))
+    uint8_t* flags;                 // Node flags
+    uint8_t (*id)[FLAT_ID_BYTES];   // Binary account IDs
+    uint64_t* created;              // Creation times
+    uint64_t* expires;              // Expiry times
+} FlatTree;
+
+// Visits one node by index
+typedef void (*FlatVisitor)(const FlatTree* flat, uint32_t index, void* user_data);
+
+// Flat Functions
+bool flat_init(FlatTree* flat, uint32_t capacity);
+void flat_destroy(FlatTree* flat);
+void flat_clear(FlatTree* flat);
+uint32_t flat_append(FlatTree* flat, uint32_t parent, const uint8_t* id, uint8_t flags,
+                     uint64_t created, uint64_t expires);
+size_t flat_node_bytes(void);
+void flat_dfs(const FlatTree* flat, FlatVisitor visitor, void* user_data);
+bool flat_bfs(const FlatTree* flat, FlatVisitor visitor, void* user_data);
+
+#endif // FLAT_H
@@ -0,0 +1,222 @@
+#include "hex.h"
+
+#include <string.h>
+#include <stdatomic.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define HEX_X86 1
+    #include <immintrin.h>
+#endif
+
+// One codec implementation
+typedef struct {
+    const char* name;
+    void (*encode)(const uint8_t* bytes, size_t count, char* hex);
+    bool (*decode)(const char* hex, size_t count, uint8_t* bytes);
+} HexKernel;
+
+// Digit values with HEX_VALID set; zero for anything that is not a digit
+#define HEX_VALID 0x10
+static const uint8_t hex_values[256] = {
+    ['0'] = 0x10, ['1'] = 0x11, ['2'] = 0x12, ['3'] = 0x13, ['4'] = 0x14,
+    ['5'] = 0x15, ['6'] = 0x16, ['7'] = 0x17, ['8'] = 0x18, ['9'] = 0x19,
+    ['a'] = 0x1A, ['b'] = 0x1B, ['c'] = 0x1C, ['d'] = 0x1D, ['e'] = 0x1E, ['f'] = 0x1F,
+    ['A'] = 0x1A, ['B'] = 0x1B, ['C'] = 0x1C, ['D'] = 0x1D, ['E'] = 0x1E, ['F'] = 0x1F
+};
+
+static void hex_encode_scalar(const uint8_t* bytes, size_t count, char* hex) {
+    for (size_t i = 0; i < count; i++) {
+        hex[i * 2] = HEX_DIGITS[bytes[i] >> 4];
+        hex[i * 2 + 1] = HEX_DIGITS[bytes[i] & 0x0F];
+    }
+}
+
+static bool hex_decode_scalar(const char* hex, size_t count, uint8_t* bytes) {
+    for (size_t i = 0; i < count; i++) {
+        uint8_t high = hex_values[(uint8_t)hex[i * 2]];
+        uint8_t low = hex_values[(uint8_t)hex[i * 2 + 1]];
+        if (!(high & low & HEX_VALID)) return false;
+        bytes[i] = (uint8_t)((high & 0x0F) << 4 | (low & 0x0F));
+    }
+    return true;
+}
+
+#ifdef HEX_X86
+
+// Nibbles to digits with a byte shuffle: high digits interleaved with low
+// digits give the text of each byte in order. 16 bytes per step.
+__attribute__((target("ssse3")))
+static void hex_encode_ssse3(const uint8_t* bytes, size_t count, char* hex) {
+    const __m128i digits = _mm_loadu_si128((const __m128i*)HEX_DIGITS);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(bytes + i));
+        __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+        __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(v, nibble));
+        _mm_storeu_si128((__m128i*)(hex + i * 2), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128((__m128i*)(hex + i * 2 + 16), _mm_unpackhi_epi8(high, low));
+    }
+    hex_encode_scalar(bytes + i, count - i, hex + i * 2);
+}
+
+// Digit values of 16 characters; *valid collects a mask bit per character
+// that is a hex digit
+__attribute__((target("ssse3")))
+static inline __m128i hex_values_ssse3(__m128i c, int* valid) {
+    __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                  _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                   _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+    *valid &= _mm_movemask_epi8(_mm_or_si128(digit, letter));
+    return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                        _mm_and_si128(letter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+// Validate and convert 32 characters per step; each digit pair is joined
+// into a byte with one multiply-add (high * 16 + low)
+__attribute__((target("ssse3")))
+static bool hex_decode_ssse3(const char* hex, size_t count, uint8_t* bytes) {
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        int valid = 0xFFFF;
+        __m128i first = hex_values_ssse3(_mm_loadu_si128((const __m128i*)(hex + i * 2)), &valid);
+        __m128i second = hex_values_ssse3(_mm_loadu_si128((const __m128i*)(hex + i * 2 + 16)), &valid);
+        if (valid != 0xFFFF) return false;
+
+        _mm_storeu_si128((__m128i*)(bytes + i),
+                         _mm_packus_epi16(_mm_maddubs_epi16(first, weights),
+                                          _mm_maddubs_epi16(second, weights)));
+    }
+    return hex_decode_scalar(hex + i * 2, count - i, bytes + i);
+}
+
+// AVX2 versions of the above, 32 bytes per step. Unpack and pack work per
+// 128-bit lane, so the halves are put back in order afterwards.
+__attribute__((target("avx2")))
+static void hex_encode_avx2(const uint8_t* bytes, size_t count, char* hex) {
+    const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)HEX_DIGITS));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(bytes + i));
+        __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(v, nibble));
+        __m256i first = _mm256_unpacklo_epi8(high, low);
+        __m256i second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256((__m256i*)(hex + i * 2), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256((__m256i*)(hex + i * 2 + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    hex_encode_scalar(bytes + i, count - i, hex + i * 2);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i hex_values_avx2(__m256i c, uint32_t* valid) {
+    __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+    __m256i digit = _mm256_andnot_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('9')),
+                                        _mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)));
+    __m256i letter = _mm256_andnot_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('f')),
+                                         _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)));
+
+    *valid &= (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(digit, letter));
+    return _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+                           _mm256_and_si256(letter, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+}
+
+__attribute__((target("avx2")))
+static bool hex_decode_avx2(const char* hex, size_t count, uint8_t* bytes) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        uint32_t valid = UINT32_MAX;
+        __m256i first = hex_values_avx2(_mm256_loadu_si256((const __m256i*)(hex + i * 2)), &valid);
+        __m256i second = hex_values_avx2(_mm256_loadu_si256((const __m256i*)(hex + i * 2 + 32)), &valid);
+        if (valid != UINT32_MAX) return false;
+
+        __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights),
+                                             _mm256_maddubs_epi16(second, weights));
+        _mm256_storeu_si256((__m256i*)(bytes + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    return hex_decode_scalar(hex + i * 2, count - i, bytes + i);
+}
+
+#endif // HEX_X86
+
+// Kernels, best first
+static const HexKernel hex_kernels[] = {
+#ifdef HEX_X86
+    { "avx2", hex_encode_avx2, hex_decode_avx2 },
+    { "ssse3", hex_encode_ssse3, hex_decode_ssse3 },
+#endif
+    { "scalar", hex_encode_scalar, hex_decode_scalar }
+};
+
+#define HEX_KERNEL_COUNT (sizeof(hex_kernels) / sizeof(hex_kernels[0]))
+
+// Selected kernel (threads racing on first use store the same one)
+static const HexKernel* _Atomic hex_active = NULL;
+
+static bool hex_supported(const HexKernel* kernel) {
+#ifdef HEX_X86
+    __builtin_cpu_init();
+    if (kernel->encode == hex_encode_avx2) return __builtin_cpu_supports("avx2");
+    if (kernel->encode == hex_encode_ssse3) return __builtin_cpu_supports("ssse3");
+#endif
+    (void)kernel;
+    return true;
+}
+
+static const HexKernel* hex_select(void) {
+    const HexKernel* kernel = atomic_load_explicit(&hex_active, memory_order_relaxed);
+    if (kernel) return kernel;
+
+    kernel = &hex_kernels[HEX_KERNEL_COUNT - 1];
+    for (size_t i = 0; i < HEX_KERNEL_COUNT; i++) {
+        if (hex_supported(&hex_kernels[i])) {
+            kernel = &hex_kernels[i];
+            break;
+        }
+    }
+    atomic_store_explicit(&hex_active, kernel, memory_order_relaxed);
+    return kernel;
+}
+
+// Write 2 * count lowercase hex digits (no terminator)
+void hex_encode(const uint8_t* bytes, size_t count, char* hex) {
+    hex_select()->encode(bytes, count, hex);
+}
+
+// Read 2 * count hex digits; false if any is not one (bytes is then undefined)
+bool hex_decode(const char* hex, size_t count, uint8_t* bytes) {
+    return hex_select()->decode(hex, count, bytes);
+}
+
+// Force a kernel by name ("avx2", "ssse3", "scalar"; NULL for the best the
+// CPU runs); false if it is unknown or the CPU lacks it
+bool hex_set_kernel(const char* name) {
+    if (!name) {
+        atomic_store_explicit(&hex_active, NULL, memory_order_relaxed);
+        hex_select();
+        return true;
+    }
+
+    for (size_t i = 0; i < HEX_KERNEL_COUNT; i++) {
+        if (strcmp(hex_kernels[i].name, name) == 0 && hex_supported(&hex_kernels[i])) {
+            atomic_store_explicit(&hex_active, &hex_kernels[i], memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Name of the kernel in use
+const char* hex_kernel(void) {
+    return hex_select()->name;
+}
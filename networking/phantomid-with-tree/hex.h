@@ -0,0 +1,18 @@
+#ifndef HEX_H
+#define HEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Hex Constants
+#define HEX_DIGITS "0123456789abcdef"   // Encoder output (decoding accepts either case)
+
+// Hex Functions. The kernel (AVX2, SSSE3 or scalar) is picked from the CPU
+// on first use; hex_set_kernel forces one, NULL goes back to the best.
+void hex_encode(const uint8_t* bytes, size_t count, char* hex);
+bool hex_decode(const char* hex, size_t count, uint8_t* bytes);
+bool hex_set_kernel(const char* name);
+const char* hex_kernel(void);
+
+#endif // HEX_H
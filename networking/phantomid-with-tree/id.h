@@ -0,0 +1,78 @@
+#ifndef ID_H
+#define ID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+// ID Constants
+#define ID_BYTES 32                 // Binary account ID (SHA-256 digest)
+
+// Key words id_hash adds before multiplying (the same in every build)
+#define ID_HASH_KEYS_LOW 0x9E3779B9, 0x7F4A7C15, 0x85EBCA6B, 0xC2B2AE35
+#define ID_HASH_KEYS_HIGH 0x27D4EB2F, 0x165667B1, 0xD3A2646C, 0xFD7046C5
+
+// ID Functions (inline: both run for every entry an index lookup touches).
+// AVX2 builds work on one 32-byte lane, SSE2 on two 16-byte lanes; anything
+// else falls back to plain words.
+
+// Whether two binary IDs are equal
+static inline bool id_equal(const uint8_t* a, const uint8_t* b) {
+#if defined(__AVX2__)
+    __m256i x = _mm256_loadu_si256((const __m256i*)a);
+    __m256i y = _mm256_loadu_si256((const __m256i*)b);
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) == -1;
+#elif defined(__SSE2__)
+    __m128i low = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)a),
+                                 _mm_loadu_si128((const __m128i*)b));
+    __m128i high = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + 16)),
+                                  _mm_loadu_si128((const __m128i*)(b + 16)));
+    return _mm_movemask_epi8(_mm_and_si128(low, high)) == 0xFFFF;
+#else
+    uint64_t x[4], y[4];
+    memcpy(x, a, ID_BYTES);
+    memcpy(y, b, ID_BYTES);
+    return ((x[0] ^ y[0]) | (x[1] ^ y[1]) | (x[2] ^ y[2]) | (x[3] ^ y[3])) == 0;
+#endif
+}
+
+// Hash a binary ID (NH: each 32-bit word plus a key word, multiplied in
+// pairs into 64 bits and summed), then mix so the low bits that pick a
+// bucket depend on every word
+static inline uint64_t id_hash(const uint8_t* id) {
+    uint64_t sums[2];
+#if defined(__AVX2__)
+    __m256i v = _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)id),
+                                 _mm256_setr_epi32(ID_HASH_KEYS_LOW, ID_HASH_KEYS_HIGH));
+    __m256i products = _mm256_mul_epu32(v, _mm256_srli_epi64(v, 32));
+    _mm_storeu_si128((__m128i*)sums, _mm_add_epi64(_mm256_castsi256_si128(products),
+                                                    _mm256_extracti128_si256(products, 1)));
+#elif defined(__SSE2__)
+    __m128i low = _mm_add_epi32(_mm_loadu_si128((const __m128i*)id),
+                                _mm_setr_epi32(ID_HASH_KEYS_LOW));
+    __m128i high = _mm_add_epi32(_mm_loadu_si128((const __m128i*)(id + 16)),
+                                 _mm_setr_epi32(ID_HASH_KEYS_HIGH));
+    _mm_storeu_si128((__m128i*)sums, _mm_add_epi64(_mm_mul_epu32(low, _mm_srli_epi64(low, 32)),
+                                                   _mm_mul_epu32(high, _mm_srli_epi64(high, 32))));
+#else
+    static const uint32_t keys[8] = { ID_HASH_KEYS_LOW, ID_HASH_KEYS_HIGH };
+    uint32_t words[8];
+    memcpy(words, id, ID_BYTES);
+    sums[0] = 0;
+    sums[1] = 0;
+    for (int i = 0; i < 8; i += 2) {
+        sums[(i >> 1) & 1] += (uint64_t)(uint32_t)(words[i] + keys[i]) *
+                              (uint32_t)(words[i + 1] + keys[i + 1]);
+    }
+#endif
+    uint64_t hash = sums[0] + sums[1];
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    return hash ^ (hash >> 33);
+}
+
+#endif // ID_H
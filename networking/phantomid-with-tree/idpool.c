@@ -0,0 +1,239 @@
+#include "idpool.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+// Ring slot: sequence == position when free for the refill thread,
+// position + 1 when it holds an entry for that position
+typedef struct {
+    _Atomic size_t sequence;
+    IdPoolEntry entry;
+} IdPoolSlot;
+
+// Bounded ring (takers claim positions by CAS on head, the refill thread is
+// the only writer of tail) plus the refill thread's wake-up state
+struct IdPool {
+    _Alignas(64) _Atomic size_t head;   // Next position to take
+    _Alignas(64) _Atomic size_t tail;   // Next position to fill
+    _Alignas(64) _Atomic bool wake;     // A wake-up is pending or being sent
+    _Atomic bool stopping;          // Set when the pool shuts down
+    _Atomic size_t misses;          // Takes that found the ring empty
+    _Atomic size_t batches;         // Fill calls
+    _Atomic uint64_t fill_ns;       // Time spent in fill calls
+    IdPoolSlot* slots;
+    size_t mask;                    // Slots - 1 (power of two)
+    size_t low_water;
+    IdPoolFill fill;
+    void* context;
+    pthread_mutex_t lock;           // Guards the sleep below
+    pthread_cond_t refill;          // Refill thread waits here
+    pthread_t thread;
+    bool started;
+};
+
+static uint64_t idpool_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+// Entries waiting (head is read first so the difference never goes negative)
+static size_t idpool_ready(IdPool* pool) {
+    size_t head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&pool->tail, memory_order_acquire);
+    return tail - head;
+}
+
+// Publish one entry (refill thread only); false while the slot's last taker
+// is still copying out of it
+static bool idpool_push(IdPool* pool, const IdPoolEntry* entry) {
+    size_t pos = atomic_load_explicit(&pool->tail, memory_order_relaxed);
+    IdPoolSlot* slot = &pool->slots[pos & pool->mask];
+
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != pos) return false;
+    slot->entry = *entry;
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+    atomic_store_explicit(&pool->tail, pos + 1, memory_order_release);
+    return true;
+}
+
+// Wake the refill thread once per drop below the low-water mark
+static void idpool_wake(IdPool* pool) {
+    if (atomic_load_explicit(&pool->wake, memory_order_relaxed)) return;
+    if (atomic_exchange_explicit(&pool->wake, true, memory_order_acq_rel)) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->refill);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Refill thread: top the ring up to capacity in fill-sized batches, then sleep
+// until takers drain it below the low-water mark
+static void* idpool_thread_main(void* arg) {
+    IdPool* pool = arg;
+    IdPoolEntry* batch = malloc(IDPOOL_BATCH * sizeof(IdPoolEntry));
+    size_t filled = 0;              // Entries in batch
+    size_t pushed = 0;              // Entries of batch already in the ring
+
+    pthread_mutex_lock(&pool->lock);
+    while (batch && !atomic_load_explicit(&pool->stopping, memory_order_relaxed)) {
+        pthread_mutex_unlock(&pool->lock);
+
+        bool failed = false;
+        while (!atomic_load_explicit(&pool->stopping, memory_order_relaxed)) {
+            if (pushed == filled) {
+                size_t room = pool->mask + 1 - idpool_ready(pool);
+                if (room == 0) break;
+
+                size_t count = room < IDPOOL_BATCH ? room : IDPOOL_BATCH;
+                uint64_t start = idpool_now_ns();
+                if (!pool->fill(batch, count, pool->context)) {
+                    failed = true;
+                    break;
+                }
+                atomic_fetch_add_explicit(&pool->fill_ns, idpool_now_ns() - start, memory_order_relaxed);
+                atomic_fetch_add_explicit(&pool->batches, 1, memory_order_relaxed);
+                filled = count;
+                pushed = 0;
+            }
+            if (!idpool_push(pool, &batch[pushed])) break;
+            pushed++;
+        }
+
+        // Clear the flag before checking the level: a taker that drains the
+        // ring after the check finds it clear and signals once we sleep
+        pthread_mutex_lock(&pool->lock);
+        atomic_store_explicit(&pool->wake, false, memory_order_release);
+        while (!atomic_load_explicit(&pool->stopping, memory_order_relaxed) &&
+               (failed || idpool_ready(pool) >= pool->low_water)) {
+            pthread_cond_wait(&pool->refill, &pool->lock);
+            failed = false;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    // Unused pairs are secrets; don't leave them in freed memory
+    if (batch) {
+        memset(batch, 0, IDPOOL_BATCH * sizeof(IdPoolEntry));
+        free(batch);
+    }
+    return NULL;
+}
+
+IdPool* idpool_create(size_t capacity, size_t low_water, IdPoolFill fill, void* context) {
+    if (capacity == 0 || !fill) return NULL;
+
+    size_t slots = 1;
+    while (slots < capacity) slots <<= 1;
+    if (low_water > slots) low_water = slots;
+
+    IdPool* pool = aligned_alloc(_Alignof(IdPool), sizeof(IdPool));
+    if (!pool) return NULL;
+    memset(pool, 0, sizeof(IdPool));
+
+    pool->slots = malloc(slots * sizeof(IdPoolSlot));
+    if (!pool->slots) {
+        free(pool);
+        return NULL;
+    }
+    for (size_t i = 0; i < slots; i++) {
+        atomic_init(&pool->slots[i].sequence, i);
+    }
+
+    atomic_init(&pool->head, 0);
+    atomic_init(&pool->tail, 0);
+    atomic_init(&pool->wake, false);
+    atomic_init(&pool->stopping, false);
+    atomic_init(&pool->misses, 0);
+    atomic_init(&pool->batches, 0);
+    atomic_init(&pool->fill_ns, 0);
+    pool->mask = slots - 1;
+    pool->low_water = low_water;
+    pool->fill = fill;
+    pool->context = context;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->refill, NULL);
+
+    // The thread starts with an empty ring, so it fills straight away
+    if (pthread_create(&pool->thread, NULL, idpool_thread_main, pool) != 0) {
+        idpool_destroy(pool);
+        return NULL;
+    }
+    pool->started = true;
+    return pool;
+}
+
+void idpool_destroy(IdPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    atomic_store_explicit(&pool->stopping, true, memory_order_relaxed);
+    pthread_cond_broadcast(&pool->refill);
+    pthread_mutex_unlock(&pool->lock);
+
+    if (pool->started) pthread_join(pool->thread, NULL);
+
+    pthread_cond_destroy(&pool->refill);
+    pthread_mutex_destroy(&pool->lock);
+    memset(pool->slots, 0, (pool->mask + 1) * sizeof(IdPoolSlot));
+    free(pool->slots);
+    free(pool);
+}
+
+// Take one ready entry; false when the ring is empty (the caller generates
+// its own and the refill thread is woken)
+bool idpool_take(IdPool* pool, IdPoolEntry* entry) {
+    if (!pool) return false;
+
+    size_t pos = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    IdPoolSlot* slot;
+    for (;;) {
+        slot = &pool->slots[pos & pool->mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&pool->head, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&pool->misses, 1, memory_order_relaxed);
+            idpool_wake(pool);
+            return false;
+        } else {
+            pos = atomic_load_explicit(&pool->head, memory_order_relaxed);
+        }
+    }
+
+    *entry = slot->entry;
+    atomic_store_explicit(&slot->sequence, pos + pool->mask + 1, memory_order_release);
+
+    if (idpool_ready(pool) < pool->low_water) idpool_wake(pool);
+    return true;
+}
+
+// Take up to count entries; returns how many were ready
+size_t idpool_take_many(IdPool* pool, IdPoolEntry* entries, size_t count) {
+    size_t taken = 0;
+    while (taken < count && idpool_take(pool, &entries[taken])) taken++;
+    return taken;
+}
+
+void idpool_stats(IdPool* pool, IdPoolStats* stats) {
+    memset(stats, 0, sizeof(IdPoolStats));
+    if (!pool) return;
+
+    uint64_t fill_ns = atomic_load_explicit(&pool->fill_ns, memory_order_relaxed);
+    stats->capacity = pool->mask + 1;
+    stats->low_water = pool->low_water;
+    stats->taken = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    stats->generated = atomic_load_explicit(&pool->tail, memory_order_relaxed);
+    stats->ready = stats->generated > stats->taken ? stats->generated - stats->taken : 0;
+    stats->misses = atomic_load_explicit(&pool->misses, memory_order_relaxed);
+    stats->batches = atomic_load_explicit(&pool->batches, memory_order_relaxed);
+    stats->refill_rate = fill_ns > 0 ? (double)stats->generated * 1e9 / (double)fill_ns : 0.0;
+}
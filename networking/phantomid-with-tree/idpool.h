@@ -0,0 +1,45 @@
+#ifndef IDPOOL_H
+#define IDPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "id.h"
+
+// ID Pool Constants
+#define IDPOOL_CAPACITY 16384       // Default ready pairs (rounded up to a power of two)
+#define IDPOOL_BATCH 1024           // Pairs generated per fill call
+
+// One ready account identity
+typedef struct {
+    uint8_t seed[32];
+    uint8_t id[ID_BYTES];
+} IdPoolEntry;
+
+// Generates count entries on the refill thread; false leaves the pool as is
+// until the next wake-up
+typedef bool (*IdPoolFill)(IdPoolEntry* entries, size_t count, void* context);
+
+// ID pool statistics snapshot
+typedef struct {
+    size_t capacity;                // Slots
+    size_t low_water;               // Refill starts when fewer are ready
+    size_t ready;                   // Entries waiting to be taken
+    size_t taken;                   // Entries handed out
+    size_t misses;                  // Takes that found the pool empty
+    size_t generated;               // Entries produced by the refill thread
+    size_t batches;                 // Fill calls
+    double refill_rate;             // Entries per second of fill time
+} IdPoolStats;
+
+typedef struct IdPool IdPool;
+
+// ID Pool Functions. Any thread may take; one background thread refills the
+// pool up to capacity whenever it drops below the low-water mark.
+IdPool* idpool_create(size_t capacity, size_t low_water, IdPoolFill fill, void* context);
+void idpool_destroy(IdPool* pool);
+bool idpool_take(IdPool* pool, IdPoolEntry* entry);
+size_t idpool_take_many(IdPool* pool, IdPoolEntry* entries, size_t count);
+void idpool_stats(IdPool* pool, IdPoolStats* stats);
+
+#endif // IDPOOL_H
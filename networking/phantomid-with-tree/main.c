@@ -20,6 +20,7 @@ static volatile bool running = true;
 void handle_signal(int sig) {
     printf("\nReceived signal %d, initiating shutdown...\n", sig);
     running = false;
+    phantom_stop(&phantom_daemon);
 }
 
 // Print program usage
@@ -28,8 +29,19 @@ void print_usage(const char* program_name) {
     printf("Usage: %s [OPTIONS]\n", program_name);
     printf("Options:\n");
     printf("  -p, --port PORT    Port to listen on (default: 8888)\n");
+    printf("  -b, --backend NAME Event loop backend: auto, select, epoll, uring (default: auto)\n");
+    printf("  -t, --threads N    Reactor threads sharing the port (default: 1)\n");
+    printf("  -w, --workers N    Command worker threads, 0 runs commands inline (default: CPUs)\n");
+    printf("  -T, --visit-threads N Threads for parallel tree visits (default: CPUs)\n");
+    printf("  -I, --id-pool N    Account IDs generated ahead, 0 generates on demand (default: %d)\n", IDPOOL_CAPACITY);
+    printf("  -L, --lifetime SECS Account lifetime before expiry (default: %d)\n", PHANTOM_ACCOUNT_LIFETIME);
+    printf("  -E, --expiry-batch N Accounts expired per event-loop tick, 0 keeps them (default: %d)\n", PHANTOM_EXPIRY_BATCH);
+    printf("  -c, --clients N    Maximum clients per reactor (default: %d)\n", NET_MAX_CLIENTS);
+    printf("  -P, --pin          Pin each reactor thread to its own CPU\n");
     printf("  -v, --verbose      Enable verbose logging\n");
     printf("  -d, --debug        Enable debug mode\n");
+    printf("  -B, --bench-hex N  Time the hex codec on N IDs against sprintf/sscanf and exit\n");
+    printf("  -S, --bench-ids N  Time ID derivation on N seeds against OpenSSL EVP and exit\n");
     printf("  -h, --help         Show this help message\n");
 }
 
@@ -63,8 +75,10 @@ void print_status(const PhantomDaemon* phantom) {
 // Debug visitor function for tree traversal
 void debug_visitor(PhantomNode* node, void* user_data) {
     bool is_verbose = *(bool*)user_data;
+    char id[PHANTOM_ID_HEX];
+    phantom_id_to_hex(node->account.id, id);
     printf("Node ID: %s (Root: %s, Admin: %s)\n",
-           node->account.id,
+           id,
            node->is_root ? "Yes" : "No",
            node->is_admin ? "Yes" : "No");
     
@@ -75,6 +89,175 @@ void debug_visitor(PhantomNode* node, void* user_data) {
     }
 }
 
+// Seconds of CPU time between two clock() readings
+static double elapsed(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Hex codec microbenchmark: encode and decode count random IDs with every
+// kernel the CPU runs, checked against and timed next to the sprintf and
+// sscanf path the IDs used to take
+int bench_hex(size_t count) {
+    uint8_t* ids = malloc(count * PHANTOM_ID_BYTES);
+    uint8_t* decoded = malloc(count * PHANTOM_ID_BYTES);
+    char* reference = malloc(count * PHANTOM_ID_HEX);
+    char* text = malloc(count * PHANTOM_ID_HEX);
+    if (!ids || !decoded || !reference || !text) {
+        fprintf(stderr, "Failed to allocate %zu IDs\n", count);
+        free(ids);
+        free(decoded);
+        free(reference);
+        free(text);
+        return 1;
+    }
+    
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < count * PHANTOM_ID_BYTES; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        ids[i] = (uint8_t)x;
+    }
+    
+    clock_t start = clock();
+    for (size_t i = 0; i < count; i++) {
+        for (size_t b = 0; b < PHANTOM_ID_BYTES; b++) {
+            sprintf(&reference[i * PHANTOM_ID_HEX + b * 2], "%02x", ids[i * PHANTOM_ID_BYTES + b]);
+        }
+    }
+    double encode_base = elapsed(start);
+    
+    start = clock();
+    for (size_t i = 0; i < count; i++) {
+        for (size_t b = 0; b < PHANTOM_ID_BYTES; b++) {
+            unsigned int byte;
+            sscanf(&reference[i * PHANTOM_ID_HEX + b * 2], "%2x", &byte);
+            decoded[i * PHANTOM_ID_BYTES + b] = (uint8_t)byte;
+        }
+    }
+    double decode_base = elapsed(start);
+    
+    printf("Hex codec, %zu IDs (ns per ID):\n", count);
+    printf("  %-8s encode %8.1f  decode %8.1f\n", "sprintf",
+           encode_base * 1e9 / count, decode_base * 1e9 / count);
+    
+    const char* kernels[] = { "scalar", "ssse3", "avx2" };
+    bool valid = memcmp(decoded, ids, count * PHANTOM_ID_BYTES) == 0;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (!hex_set_kernel(kernels[k])) {
+            printf("  %-8s not supported by this CPU\n", kernels[k]);
+            continue;
+        }
+        
+        start = clock();
+        for (size_t i = 0; i < count; i++) {
+            phantom_id_to_hex(&ids[i * PHANTOM_ID_BYTES], &text[i * PHANTOM_ID_HEX]);
+        }
+        double encode = elapsed(start);
+        
+        memset(decoded, 0, count * PHANTOM_ID_BYTES);
+        start = clock();
+        for (size_t i = 0; i < count; i++) {
+            phantom_id_from_hex(&reference[i * PHANTOM_ID_HEX], &decoded[i * PHANTOM_ID_BYTES]);
+        }
+        double decode = elapsed(start);
+        
+        bool matches = memcmp(text, reference, count * PHANTOM_ID_HEX) == 0 &&
+                       memcmp(decoded, ids, count * PHANTOM_ID_BYTES) == 0;
+        valid = valid && matches;
+        printf("  %-8s encode %8.1f  decode %8.1f  (%.1fx / %.1fx)%s\n", kernels[k],
+               encode * 1e9 / count, decode * 1e9 / count,
+               encode > 0 ? encode_base / encode : 0.0, decode > 0 ? decode_base / decode : 0.0,
+               matches ? "" : "  MISMATCH");
+    }
+    hex_set_kernel(NULL);
+    printf("Default kernel: %s\n", hex_kernel());
+    
+    free(ids);
+    free(decoded);
+    free(reference);
+    free(text);
+    return valid ? 0 : 1;
+}
+
+// The derivation IDs used before the SHA-256 kernels: one EVP digest per
+// seed through a shared context
+static void derive_evp(const uint8_t* seeds, uint8_t* ids, size_t count, size_t stride) {
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    if (!ctx) return;
+    
+    for (size_t i = 0; i < count; i++) {
+        unsigned int len;
+        EVP_DigestInit_ex(ctx, EVP_sha256(), NULL);
+        EVP_DigestUpdate(ctx, seeds + i * stride, 32);
+        EVP_DigestFinal_ex(ctx, ids + i * stride, &len);
+    }
+    EVP_MD_CTX_free(ctx);
+}
+
+// ID derivation microbenchmark: derive IDs for count random seeds with every
+// SHA-256 kernel the CPU runs, checked against and timed next to EVP
+int bench_ids(size_t count) {
+    IdPoolEntry* entries = malloc(count * sizeof(IdPoolEntry));
+    uint8_t* reference = malloc(count * PHANTOM_ID_BYTES);
+    if (!entries || !reference) {
+        fprintf(stderr, "Failed to allocate %zu seeds\n", count);
+        free(entries);
+        free(reference);
+        return 1;
+    }
+    
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t b = 0; b < sizeof(entries[i].seed); b++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            entries[i].seed[b] = (uint8_t)x;
+        }
+    }
+    
+    phantom_set_id_derive(derive_evp);
+    clock_t start = clock();
+    phantom_derive_ids(entries[0].seed, entries[0].id, count, sizeof(IdPoolEntry));
+    double base = elapsed(start);
+    phantom_set_id_derive(NULL);
+    for (size_t i = 0; i < count; i++) {
+        memcpy(&reference[i * PHANTOM_ID_BYTES], entries[i].id, PHANTOM_ID_BYTES);
+    }
+    
+    printf("ID derivation, %zu seeds (ns per ID):\n", count);
+    printf("  %-8s %8.1f\n", "evp", base * 1e9 / count);
+    
+    const char* kernels[] = { "scalar", "avx2", "shani", "avx512" };
+    bool valid = true;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (!sha256_set_kernel(kernels[k])) {
+            printf("  %-8s not supported by this CPU\n", kernels[k]);
+            continue;
+        }
+        
+        for (size_t i = 0; i < count; i++) memset(entries[i].id, 0, PHANTOM_ID_BYTES);
+        start = clock();
+        phantom_derive_ids(entries[0].seed, entries[0].id, count, sizeof(IdPoolEntry));
+        double derive = elapsed(start);
+        
+        bool matches = true;
+        for (size_t i = 0; i < count && matches; i++) {
+            matches = memcmp(entries[i].id, &reference[i * PHANTOM_ID_BYTES], PHANTOM_ID_BYTES) == 0;
+        }
+        valid = valid && matches;
+        printf("  %-8s %8.1f  (%.1fx)%s\n", kernels[k], derive * 1e9 / count,
+               derive > 0 ? base / derive : 0.0, matches ? "" : "  MISMATCH");
+    }
+    sha256_set_kernel(NULL);
+    printf("Default kernel: %s\n", sha256_kernel());
+    
+    free(entries);
+    free(reference);
+    return valid ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
 #ifdef _WIN32
     WSADATA wsaData;
@@ -84,7 +267,8 @@ int main(int argc, char* argv[]) {
     }
 #endif
 
-    uint16_t port = 8888;
+    PhantomConfig config;
+    phantom_config_defaults(&config);
     bool verbose = false;
     bool debug = false;
     
@@ -98,7 +282,7 @@ int main(int argc, char* argv[]) {
             if (i + 1 < argc) {
                 int temp_port = atoi(argv[i + 1]);
                 if (temp_port > 0 && temp_port < 65536) {
-                    port = (uint16_t)temp_port;
+                    config.port = (uint16_t)temp_port;
                     i++;
                 } else {
                     fprintf(stderr, "Invalid port number. Must be between 1 and 65535\n");
@@ -109,12 +293,163 @@ int main(int argc, char* argv[]) {
                 return 1;
             }
         }
+        else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--backend") == 0) {
+            if (i + 1 < argc && net_backend_from_name(argv[i + 1], &config.backend)) {
+                i++;
+            } else {
+                fprintf(stderr, "Invalid backend. Use auto, select, epoll or uring\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 < argc) {
+                int temp_threads = atoi(argv[i + 1]);
+                if (temp_threads > 0 && temp_threads <= 1024) {
+                    config.reactors = (size_t)temp_threads;
+                    i++;
+                } else {
+                    fprintf(stderr, "Invalid thread count. Must be between 1 and 1024\n");
+                    return 1;
+                }
+            } else {
+                fprintf(stderr, "Thread count not provided\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--workers") == 0) {
+            if (i + 1 < argc) {
+                char* end = NULL;
+                long temp_workers = strtol(argv[i + 1], &end, 10);
+                if (end != argv[i + 1] && *end == '\0' &&
+                    temp_workers >= 0 && temp_workers <= 1024) {
+                    config.workers = (size_t)temp_workers;
+                    i++;
+                } else {
+                    fprintf(stderr, "Invalid worker count. Must be between 0 and 1024\n");
+                    return 1;
+                }
+            } else {
+                fprintf(stderr, "Worker count not provided\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-T") == 0 || strcmp(argv[i], "--visit-threads") == 0) {
+            if (i + 1 < argc) {
+                char* end = NULL;
+                long temp_visit = strtol(argv[i + 1], &end, 10);
+                if (end != argv[i + 1] && *end == '\0' &&
+                    temp_visit >= 1 && temp_visit <= 1024) {
+                    config.visit_threads = (size_t)temp_visit;
+                    i++;
+                } else {
+                    fprintf(stderr, "Invalid visit thread count. Must be between 1 and 1024\n");
+                    return 1;
+                }
+            } else {
+                fprintf(stderr, "Visit thread count not provided\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-I") == 0 || strcmp(argv[i], "--id-pool") == 0) {
+            if (i + 1 < argc) {
+                char* end = NULL;
+                long temp_pool = strtol(argv[i + 1], &end, 10);
+                if (end != argv[i + 1] && *end == '\0' &&
+                    temp_pool >= 0 && temp_pool <= (1L << 24)) {
+                    config.id_pool = (size_t)temp_pool;
+                    i++;
+                } else {
+                    fprintf(stderr, "Invalid ID pool size. Must be between 0 and %ld\n", 1L << 24);
+                    return 1;
+                }
+            } else {
+                fprintf(stderr, "ID pool size not provided\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-L") == 0 || strcmp(argv[i], "--lifetime") == 0) {
+            if (i + 1 < argc) {
+                char* end = NULL;
+                long long temp_lifetime = strtoll(argv[i + 1], &end, 10);
+                if (end != argv[i + 1] && *end == '\0' && temp_lifetime > 0) {
+                    config.account_lifetime = (uint64_t)temp_lifetime;
+                    i++;
+                } else {
+                    fprintf(stderr, "Invalid lifetime. Must be a positive number of seconds\n");
+                    return 1;
+                }
+            } else {
+                fprintf(stderr, "Lifetime not provided\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-E") == 0 || strcmp(argv[i], "--expiry-batch") == 0) {
+            if (i + 1 < argc) {
+                char* end = NULL;
+                long temp_batch = strtol(argv[i + 1], &end, 10);
+                if (end != argv[i + 1] && *end == '\0' &&
+                    temp_batch >= 0 && temp_batch <= 65536) {
+                    config.expiry_batch = (size_t)temp_batch;
+                    i++;
+                } else {
+                    fprintf(stderr, "Invalid expiry batch. Must be between 0 and 65536\n");
+                    return 1;
+                }
+            } else {
+                fprintf(stderr, "Expiry batch not provided\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--clients") == 0) {
+            if (i + 1 < argc) {
+                long temp_clients = atol(argv[i + 1]);
+                if (temp_clients > 0) {
+                    config.max_clients = (size_t)temp_clients;
+                    i++;
+                } else {
+                    fprintf(stderr, "Invalid client limit. Must be positive\n");
+                    return 1;
+                }
+            } else {
+                fprintf(stderr, "Client limit not provided\n");
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "-P") == 0 || strcmp(argv[i], "--pin") == 0) {
+            config.pin_reactors = true;
+        }
         else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
             verbose = true;
         }
         else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--debug") == 0) {
             debug = true;
         }
+        else if (strcmp(argv[i], "-B") == 0 || strcmp(argv[i], "--bench-hex") == 0) {
+            if (i + 1 < argc) {
+                char* end = NULL;
+                long temp_count = strtol(argv[i + 1], &end, 10);
+                if (end != argv[i + 1] && *end == '\0' && temp_count > 0) {
+                    return bench_hex((size_t)temp_count);
+                }
+                fprintf(stderr, "Invalid ID count. Must be positive\n");
+            } else {
+                fprintf(stderr, "ID count not provided\n");
+            }
+            return 1;
+        }
+        else if (strcmp(argv[i], "-S") == 0 || strcmp(argv[i], "--bench-ids") == 0) {
+            if (i + 1 < argc) {
+                char* end = NULL;
+                long temp_count = strtol(argv[i + 1], &end, 10);
+                if (end != argv[i + 1] && *end == '\0' && temp_count > 0) {
+                    return bench_ids((size_t)temp_count);
+                }
+                fprintf(stderr, "Invalid seed count. Must be positive\n");
+            } else {
+                fprintf(stderr, "Seed count not provided\n");
+            }
+            return 1;
+        }
         else {
             fprintf(stderr, "Unknown option: %s\n", argv[i]);
             print_usage(argv[0]);
@@ -124,8 +459,8 @@ int main(int argc, char* argv[]) {
     
     setup_signals();
     
-    printf("Initializing PhantomID daemon on port %d...\n", port);
-    if (!phantom_init(&phantom_daemon, port)) {
+    printf("Initializing PhantomID daemon on port %d...\n", config.port);
+    if (!phantom_init_config(&phantom_daemon, &config)) {
         fprintf(stderr, "Failed to initialize PhantomID daemon: %s\n", 
                 phantom_get_error());
 #ifdef _WIN32
@@ -1,24 +1,174 @@
 
+#ifdef __linux__
+    #define _GNU_SOURCE  // pthread_setaffinity_np
+    #include <sched.h>
+#endif
 #include "network.h"
 
+#ifndef _WIN32
+    #include <sys/resource.h>
+#endif
+
 // Initialize client state
 void net_init_client_state(ClientState* state) {
-    pthread_mutex_init(&state->lock, NULL);
     state->is_active = false;
     state->socket_fd = 0;
+    state->generation = 0;
+    state->active_index = 0;
     memset(&state->addr, 0, sizeof(state->addr));
+    state->in_buf = NULL;
+    state->in_len = 0;
+    state->in_cap = 0;
+    state->wire = NET_WIRE_UNKNOWN;
+    state->out_head = NULL;
+    state->out_tail = NULL;
+    state->out_bytes = 0;
+    state->high_water = NET_OUTPUT_HIGH_WATER;
+    state->read_paused = false;
+    state->pending_jobs = 0;
+    state->events = 0;
 }
 
 // Clean up client state
 void net_cleanup_client_state(ClientState* state) {
-    pthread_mutex_lock(&state->lock);
-    if (state->socket_fd > 0) {
+    if (state->is_active && state->socket_fd > 0) {
         close(state->socket_fd);
-        state->socket_fd = 0;
     }
+    state->socket_fd = 0;
     state->is_active = false;
-    pthread_mutex_unlock(&state->lock);
-    pthread_mutex_destroy(&state->lock);
+    
+    free(state->in_buf);
+    state->in_buf = NULL;
+    state->in_len = 0;
+    state->in_cap = 0;
+    state->wire = NET_WIRE_UNKNOWN;
+    
+    net_free_chunks(state->out_head);
+    state->out_head = NULL;
+    state->out_tail = NULL;
+    state->out_bytes = 0;
+    state->read_paused = false;
+    state->pending_jobs = 0;
+    state->events = 0;
+}
+
+// Free a chunk list
+void net_free_chunks(NetChunk* chunk) {
+    while (chunk) {
+        NetChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+// Append bytes to a chunk list, coalescing into the tail chunk
+bool net_append_chunks(NetChunk** head, NetChunk** tail_ptr, size_t* total,
+                       const void* data, size_t size) {
+    const char* bytes = data;
+    size_t remaining = size;
+    
+    NetChunk* tail = *tail_ptr;
+    if (tail && tail->length < tail->capacity) {
+        size_t room = tail->capacity - tail->length;
+        size_t take = remaining < room ? remaining : room;
+        memcpy(tail->data + tail->length, bytes, take);
+        tail->length += take;
+        bytes += take;
+        remaining -= take;
+    }
+    
+    if (remaining > 0) {
+        size_t capacity = remaining > NET_CHUNK_SIZE ? remaining : NET_CHUNK_SIZE;
+        NetChunk* chunk = malloc(sizeof(NetChunk) + capacity);
+        if (!chunk) {
+            *total += size - remaining;
+            return false;
+        }
+        
+        chunk->next = NULL;
+        chunk->offset = 0;
+        chunk->length = remaining;
+        chunk->capacity = capacity;
+        memcpy(chunk->data, bytes, remaining);
+        
+        if (*tail_ptr) {
+            (*tail_ptr)->next = chunk;
+        } else {
+            *head = chunk;
+        }
+        *tail_ptr = chunk;
+    }
+    
+    *total += size;
+    return true;
+}
+
+// Append bytes to the client's output queue
+bool net_queue_output(ClientState* client, const void* data, size_t size) {
+    return net_append_chunks(&client->out_head, &client->out_tail, &client->out_bytes,
+                             data, size);
+}
+
+// Move a finished job's responses onto its connection and free the job;
+// returns the client, or NULL if the connection closed in the meantime
+ClientState* net_complete_job(NetworkProgram* program, NetJob* job) {
+    ClientState* client = net_find_client(program, job->socket_fd);
+    if (client && client->generation != job->generation) client = NULL;
+    
+    if (client) {
+        client->pending_jobs--;
+        if (job->out_bytes > 0 && job->out_bytes < NET_CHUNK_SIZE) {
+            // Small responses coalesce like inline ones instead of pinning a chunk each
+            for (NetChunk* chunk = job->out_head; chunk; chunk = chunk->next) {
+                if (!net_queue_output(client, chunk->data, chunk->length)) break;
+            }
+        } else if (job->out_head) {
+            if (client->out_tail) {
+                client->out_tail->next = job->out_head;
+            } else {
+                client->out_head = job->out_head;
+            }
+            client->out_tail = job->out_tail;
+            client->out_bytes += job->out_bytes;
+            job->out_head = NULL;
+        }
+    }
+    
+    net_free_chunks(job->out_head);
+    free(job);
+    return client;
+}
+
+// Advance past written bytes, freeing drained chunks; returns the new head
+NetChunk* net_consume_chunks(NetChunk* head, size_t bytes) {
+    while (head && bytes > 0) {
+        size_t pending = head->length - head->offset;
+        if (bytes < pending) {
+            head->offset += bytes;
+            break;
+        }
+        
+        bytes -= pending;
+        NetChunk* next = head->next;
+        free(head);
+        head = next;
+    }
+    return head;
+}
+
+// Pause reading above the output high-water mark or with too many commands
+// in flight on workers, resume once both fall to half
+bool net_update_backpressure(ClientState* client) {
+    bool paused = client->read_paused;
+    
+    if (!paused && (client->out_bytes > client->high_water ||
+                    client->pending_jobs >= NET_MAX_PENDING_JOBS)) {
+        client->read_paused = true;
+    } else if (paused && client->out_bytes <= client->high_water / 2 &&
+               client->pending_jobs <= NET_MAX_PENDING_JOBS / 2) {
+        client->read_paused = false;
+    }
+    return paused != client->read_paused;
 }
 
 bool net_is_port_in_use(uint16_t port) {
@@ -62,12 +212,28 @@ bool net_release_port(uint16_t port) {
     return result >= 0;
 }
 
+// Pin calling thread to a CPU (wraps around the online CPU count)
+bool net_pin_thread(size_t cpu) {
+#ifdef __linux__
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online <= 0) return false;
+    
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % (size_t)online, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
 // Update net_init to include port checking and cleanup
 bool net_init(NetworkEndpoint* endpoint) {
     if (!endpoint) return false;
     
-    // Check if port is in use
-    if (net_is_port_in_use(endpoint->port)) {
+    // Check if port is in use (shared ports are expected to be bound)
+    if (!endpoint->reuse_port && net_is_port_in_use(endpoint->port)) {
         printf("Port %d is in use, attempting to release...\n", endpoint->port);
         if (!net_release_port(endpoint->port)) {
             printf("Failed to release port %d\n", endpoint->port);
@@ -107,6 +273,18 @@ bool net_init(NetworkEndpoint* endpoint) {
         return false;
     }
     
+#ifdef SO_REUSEPORT
+    // Let sibling reactors bind their own listener on the same port
+    if (endpoint->reuse_port &&
+        setsockopt(endpoint->socket_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt SO_REUSEPORT failed");
+        close(endpoint->socket_fd);
+        pthread_mutex_unlock(&endpoint->lock);
+        pthread_mutex_destroy(&endpoint->lock);
+        return false;
+    }
+#endif
+    
     // Configure address
     endpoint->addr.sin_family = AF_INET;
     endpoint->addr.sin_port = htons(endpoint->port);
@@ -123,7 +301,7 @@ bool net_init(NetworkEndpoint* endpoint) {
         }
         
         if (endpoint->protocol == NET_TCP) {
-            if (listen(endpoint->socket_fd, NET_MAX_CLIENTS) < 0) {
+            if (listen(endpoint->socket_fd, SOMAXCONN) < 0) {
                 perror("Listen failed");
                 close(endpoint->socket_fd);
                 pthread_mutex_unlock(&endpoint->lock);
@@ -157,10 +335,30 @@ void net_close(NetworkEndpoint* endpoint) {
     pthread_mutex_destroy(&endpoint->lock);
 }
 
+// Queue output for a client endpoint (into the job when answered on a worker)
+static bool net_endpoint_output(NetworkEndpoint* endpoint, const void* data, size_t size) {
+    if (endpoint->job) {
+        NetJob* job = endpoint->job;
+        return net_append_chunks(&job->out_head, &job->out_tail, &job->out_bytes,
+                                 data, size);
+    }
+    
+    ClientState* client = net_find_client(endpoint->program, endpoint->socket_fd);
+    return client && net_queue_output(client, data, size);
+}
+
 // Send data through network endpoint
 ssize_t net_send(NetworkEndpoint* endpoint, NetworkPacket* packet) {
     if (!endpoint || !packet) return -1;
     
+    // Client endpoints queue output; the reactor flushes it when writable
+    if (endpoint->program) {
+        if (!net_endpoint_output(endpoint, packet->data, packet->size)) {
+            return -1;
+        }
+        return (ssize_t)packet->size;
+    }
+    
     ssize_t result;
     pthread_mutex_lock(&endpoint->lock);
     result = send(endpoint->socket_fd, packet->data, packet->size, packet->flags);
@@ -168,6 +366,24 @@ ssize_t net_send(NetworkEndpoint* endpoint, NetworkPacket* packet) {
     return result;
 }
 
+// Send one binary frame (length prefix plus body) through a client endpoint
+ssize_t net_send_frame(NetworkEndpoint* endpoint, NetworkPacket* packet) {
+    if (!endpoint || !packet || !endpoint->program) return -1;
+    if (packet->size > UINT32_MAX) return -1;
+    
+    uint32_t size = (uint32_t)packet->size;
+    unsigned char header[NET_FRAME_HEADER] = {
+        (unsigned char)(size >> 24), (unsigned char)(size >> 16),
+        (unsigned char)(size >> 8), (unsigned char)size
+    };
+    
+    if (!net_endpoint_output(endpoint, header, sizeof(header)) ||
+        !net_endpoint_output(endpoint, packet->data, packet->size)) {
+        return -1;
+    }
+    return (ssize_t)packet->size;
+}
+
 // Receive data through network endpoint
 ssize_t net_receive(NetworkEndpoint* endpoint, NetworkPacket* packet) {
     if (!endpoint || !packet) return -1;
@@ -179,106 +395,607 @@ ssize_t net_receive(NetworkEndpoint* endpoint, NetworkPacket* packet) {
     return result;
 }
 
+// Register client socket with the event loop
+static void net_watch_client(NetworkProgram* program, ClientState* client) {
+#ifdef __linux__
+    if (program->backend == NET_BACKEND_EPOLL) {
+        struct epoll_event ev = {
+            .events = EPOLLIN | EPOLLRDHUP,
+            .data.fd = client->socket_fd
+        };
+        if (epoll_ctl(program->poll_fd, EPOLL_CTL_ADD, client->socket_fd, &ev) < 0) {
+            perror("epoll_ctl add failed");
+        }
+        client->events = ev.events;
+    }
+#else
+    (void)program;
+    (void)client;
+#endif
+}
+
+// Unregister client socket from the event loop
+static void net_unwatch_client(NetworkProgram* program, ClientState* client) {
+#ifdef __linux__
+    if (program->backend == NET_BACKEND_EPOLL) {
+        epoll_ctl(program->poll_fd, EPOLL_CTL_DEL, client->socket_fd, NULL);
+    }
+#else
+    (void)program;
+    (void)client;
+#endif
+}
+
+// Re-arm readiness interest after output or backpressure changes
+static void net_update_interest(NetworkProgram* program, ClientState* client) {
+    net_update_backpressure(client);
+    
+#ifdef __linux__
+    if (program->backend == NET_BACKEND_EPOLL) {
+        // Paused clients drop EPOLLRDHUP too, it is level-triggered
+        uint32_t events = client->read_paused ? 0 : (EPOLLIN | EPOLLRDHUP);
+        if (client->out_head) events |= EPOLLOUT;
+        
+        if (events != client->events) {
+            struct epoll_event ev = {
+                .events = events,
+                .data.fd = client->socket_fd
+            };
+            if (epoll_ctl(program->poll_fd, EPOLL_CTL_MOD, client->socket_fd, &ev) == 0) {
+                client->events = events;
+            }
+        }
+    }
+#else
+    (void)program;
+#endif
+}
+
+// Grow the fd-indexed slab so that fd has a slot
+static bool net_reserve_clients(NetworkProgram* program, int fd) {
+    if ((size_t)fd < program->client_slots) return true;
+    
+    size_t slots = program->client_slots ? program->client_slots : NET_INITIAL_SLOTS;
+    while (slots <= (size_t)fd) slots *= 2;
+    
+    ClientState* clients = realloc(program->clients, slots * sizeof(ClientState));
+    if (!clients) return false;
+    program->clients = clients;
+    
+    int* active = realloc(program->active_fds, slots * sizeof(int));
+    if (!active) return false;
+    program->active_fds = active;
+    
+    for (size_t i = program->client_slots; i < slots; i++) {
+        net_init_client_state(&program->clients[i]);
+    }
+    program->client_slots = slots;
+    return true;
+}
+
+// Look up an active client by descriptor
+ClientState* net_find_client(NetworkProgram* program, int socket_fd) {
+    if (!program || socket_fd < 0 || (size_t)socket_fd >= program->client_slots) {
+        return NULL;
+    }
+    
+    ClientState* client = &program->clients[socket_fd];
+    return client->is_active ? client : NULL;
+}
+
+// Close client slot and swap it out of the active list
+static void net_drop_client(NetworkProgram* program, ClientState* client) {
+    size_t last = program->client_count - 1;
+    int moved_fd = program->active_fds[last];
+    
+    program->active_fds[client->active_index] = moved_fd;
+    program->clients[moved_fd].active_index = client->active_index;
+    program->client_count--;
+    
+    net_unwatch_client(program, client);
+    net_cleanup_client_state(client);
+}
+
 // Add client to program
 bool net_add_client(NetworkProgram* program, int socket_fd, struct sockaddr_in addr) {
-    if (!program) return false;
-    
-    bool added = false;
-    pthread_mutex_lock(&program->clients_lock);
-    
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        pthread_mutex_lock(&program->clients[i].lock);
-        if (!program->clients[i].is_active) {
-            program->clients[i].socket_fd = socket_fd;
-            program->clients[i].addr = addr;
-            program->clients[i].is_active = true;
-            added = true;
-            pthread_mutex_unlock(&program->clients[i].lock);
-            break;
-        }
-        pthread_mutex_unlock(&program->clients[i].lock);
+    if (!program || socket_fd < 0) return false;
+    
+    if (program->client_count >= program->max_clients) {
+        printf("Client table full (%zu clients), rejecting connection\n",
+               program->client_count);
+        return false;
+    }
+    
+#ifndef _WIN32
+    // select() cannot watch descriptors beyond FD_SETSIZE
+    if (program->backend == NET_BACKEND_SELECT && socket_fd >= FD_SETSIZE) {
+        printf("Descriptor %d exceeds FD_SETSIZE, rejecting connection\n", socket_fd);
+        return false;
+    }
+#endif
+    
+    if (!net_reserve_clients(program, socket_fd)) {
+        printf("Failed to grow client table\n");
+        return false;
     }
     
-    pthread_mutex_unlock(&program->clients_lock);
-    return added;
+    // Output is already batched per flush; don't hold it back for delayed ACKs
+    int nodelay = 1;
+    setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+    
+    ClientState* client = &program->clients[socket_fd];
+    client->socket_fd = socket_fd;
+    client->generation++;
+    client->addr = addr;
+    client->is_active = true;
+    client->high_water = program->output_high_water;
+    client->active_index = program->client_count;
+    program->active_fds[program->client_count++] = socket_fd;
+    
+    net_watch_client(program, client);
+    return true;
 }
 
 // Remove client from program
 void net_remove_client(NetworkProgram* program, int socket_fd) {
-    if (!program) return;
-    
-    pthread_mutex_lock(&program->clients_lock);
+    ClientState* client = net_find_client(program, socket_fd);
+    if (client) {
+        net_drop_client(program, client);
+    }
+}
+
+// Backend names
+static const char* backend_names[NET_BACKEND_MAX] = {
+    "auto",
+    "select",
+    "epoll",
+    "uring"
+};
+
+const char* net_backend_name(NetworkBackend backend) {
+    if (backend < 0 || backend >= NET_BACKEND_MAX) return "unknown";
+    return backend_names[backend];
+}
+
+bool net_backend_from_name(const char* name, NetworkBackend* backend) {
+    if (!name || !backend) return false;
     
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        pthread_mutex_lock(&program->clients[i].lock);
-        if (program->clients[i].is_active && program->clients[i].socket_fd == socket_fd) {
-            close(program->clients[i].socket_fd);
-            program->clients[i].is_active = false;
-            program->clients[i].socket_fd = 0;
+    for (int i = 0; i < NET_BACKEND_MAX; i++) {
+        if (strcmp(name, backend_names[i]) == 0) {
+            *backend = (NetworkBackend)i;
+            return true;
         }
-        pthread_mutex_unlock(&program->clients[i].lock);
+    }
+    return false;
+}
+
+// Set up the requested event loop backend, falling back to select
+static void net_init_backend(NetworkProgram* program) {
+    program->poll_fd = -1;
+    program->uring = NULL;
+    
+    if (program->backend == NET_BACKEND_URING) {
+        if (net_uring_init(program)) return;
+        printf("Backend uring unavailable, falling back to epoll\n");
+        program->backend = NET_BACKEND_EPOLL;
     }
     
-    pthread_mutex_unlock(&program->clients_lock);
+#ifdef __linux__
+    if (program->backend == NET_BACKEND_AUTO || program->backend == NET_BACKEND_EPOLL) {
+        program->poll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (program->poll_fd >= 0) {
+            struct epoll_event ev = {
+                .events = EPOLLIN,
+                .data.fd = program->endpoints[0].socket_fd
+            };
+            struct epoll_event wake = {
+                .events = EPOLLIN,
+                .data.fd = program->wake_fd
+            };
+            if (program->endpoints && program->count > 0 &&
+                epoll_ctl(program->poll_fd, EPOLL_CTL_ADD,
+                          program->endpoints[0].socket_fd, &ev) == 0 &&
+                (program->wake_fd < 0 ||
+                 epoll_ctl(program->poll_fd, EPOLL_CTL_ADD, program->wake_fd, &wake) == 0)) {
+                program->backend = NET_BACKEND_EPOLL;
+                return;
+            }
+            perror("epoll_ctl listener failed");
+            close(program->poll_fd);
+            program->poll_fd = -1;
+        } else {
+            perror("epoll_create1 failed");
+        }
+    }
+#endif
+
+    if (program->backend != NET_BACKEND_AUTO && program->backend != NET_BACKEND_SELECT) {
+        printf("Backend %s unavailable, falling back to select\n",
+               net_backend_name(program->backend));
+    }
+    program->backend = NET_BACKEND_SELECT;
 }
 
-// Initialize network program
+// Initialize network program (endpoints must already be listening)
 void net_init_program(NetworkProgram* program) {
     if (!program) return;
     
-    pthread_mutex_init(&program->clients_lock, NULL);
     program->running = true;
+    program->clients = NULL;
+    program->active_fds = NULL;
+    program->client_slots = 0;
+    program->client_count = 0;
+    if (program->max_clients == 0) {
+        program->max_clients = NET_MAX_CLIENTS;
+    }
+    if (program->output_high_water == 0) {
+        program->output_high_water = NET_OUTPUT_HIGH_WATER;
+    }
     
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        net_init_client_state(&program->clients[i]);
+    // Workers post finished commands back through the wake descriptor
+    program->wake_fd = -1;
+    program->wake_signal_fd = -1;
+    net_queue_init(&program->completions);
+    if (program->workers && !net_init_wake(program)) {
+        printf("Worker wake-up unavailable, running commands inline\n");
+        program->workers = NULL;
     }
+    
+#ifndef _WIN32
+    // Make room for the configured number of client descriptors
+    struct rlimit limit;
+    rlim_t wanted = (rlim_t)program->max_clients + 64;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < wanted) {
+        limit.rlim_cur = wanted < limit.rlim_max ? wanted : limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+#endif
+    
+    net_init_backend(program);
 }
 
 // Clean up network program
 void net_cleanup_program(NetworkProgram* program) {
     if (!program) return;
     
-    pthread_mutex_lock(&program->clients_lock);
     program->running = false;
     
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        net_cleanup_client_state(&program->clients[i]);
+    for (size_t i = 0; i < program->client_count; i++) {
+        net_cleanup_client_state(&program->clients[program->active_fds[i]]);
     }
+    free(program->clients);
+    free(program->active_fds);
+    program->clients = NULL;
+    program->active_fds = NULL;
+    program->client_slots = 0;
+    program->client_count = 0;
     
-    pthread_mutex_unlock(&program->clients_lock);
-    pthread_mutex_destroy(&program->clients_lock);
+    if (program->poll_fd >= 0) {
+        close(program->poll_fd);
+        program->poll_fd = -1;
+    }
+    net_uring_cleanup(program);
+    net_cleanup_wake(program);
 }
 
-// Run network program
-void net_run(NetworkProgram* program) {
-    if (!program || !program->running) return;
+// Accept a pending connection on the listener
+static void net_accept_client(NetworkProgram* program) {
+    struct sockaddr_in client_addr;
+    socklen_t addr_len = sizeof(client_addr);
+    
+    int new_socket = accept(program->endpoints[0].socket_fd,
+                          (struct sockaddr*)&client_addr,
+                          &addr_len);
+
+    if (new_socket < 0) return;
+    
+    // Set socket to non-blocking mode
+    int flags = fcntl(new_socket, F_GETFL, 0);
+    if (flags >= 0) {
+        fcntl(new_socket, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    // Add client
+    if (net_add_client(program, new_socket, client_addr)) {
+        NetworkEndpoint client_endpoint = {
+            .socket_fd = new_socket,
+            .addr = client_addr,
+            .phantom = program->phantom,
+            .program = program
+        };
+        
+        if (program->handlers.on_connect) {
+            program->handlers.on_connect(&client_endpoint);
+        }
+    } else {
+        close(new_socket);
+    }
+}
+
+// Make room for at least extra more bytes of client input (plus terminator)
+static bool net_reserve_input(ClientState* client, size_t extra) {
+    size_t needed = client->in_len + extra + 1;
+    if (needed <= client->in_cap) return true;
+    
+    size_t cap = client->in_cap ? client->in_cap : NET_BUFFER_SIZE;
+    while (cap < needed) cap *= 2;
+    
+    char* buffer = realloc(client->in_buf, cap);
+    if (!buffer) return false;
+    
+    client->in_buf = buffer;
+    client->in_cap = cap;
+    return true;
+}
+
+// Hand one framed command to the receive handler (or the worker pool)
+static bool net_deliver(NetworkProgram* program, ClientState* client,
+                        char* data, size_t size, uint32_t flags) {
+    if (!program->handlers.on_receive) return true;
+    
+    if (program->workers) {
+        if (net_submit_job(program, client, data, size, flags)) return true;
+        printf("Failed to queue command, disconnecting client\n");
+        return false;
+    }
+    
+    NetworkEndpoint client_endpoint = {
+        .socket_fd = client->socket_fd,
+        .addr = client->addr,
+        .phantom = program->phantom,
+        .program = program
+    };
+    NetworkPacket packet = {
+        .data = data,
+        .size = size,
+        .flags = flags
+    };
+    program->handlers.on_receive(&client_endpoint, &packet);
+    return true;
+}
+
+// Dispatch newline-terminated text commands starting at start
+static size_t net_dispatch_text(NetworkProgram* program, ClientState* client,
+                                size_t start, bool* valid) {
+    char* buffer = client->in_buf;
+    
+    while (start < client->in_len) {
+        char* newline = memchr(buffer + start, '\n', client->in_len - start);
+        if (!newline) break;
+        
+        size_t end = (size_t)(newline - buffer);
+        size_t length = end - start;
+        if (length > 0 && buffer[start + length - 1] == '\r') length--;
+        buffer[start + length] = '\0';
+        
+        if (length > 0 && !net_deliver(program, client, buffer + start, length, 0)) {
+            *valid = false;
+            break;
+        }
+        
+        start = end + 1;
+    }
+    return start;
+}
+
+// Dispatch length-prefixed binary frames starting at start
+static size_t net_dispatch_binary(NetworkProgram* program, ClientState* client,
+                                  size_t start, bool* valid) {
+    unsigned char* buffer = (unsigned char*)client->in_buf;
+    
+    while (client->in_len - start >= NET_FRAME_HEADER) {
+        size_t length = ((size_t)buffer[start] << 24) |
+                        ((size_t)buffer[start + 1] << 16) |
+                        ((size_t)buffer[start + 2] << 8) |
+                        (size_t)buffer[start + 3];
+        if (length > NET_MAX_COMMAND) {
+            printf("Binary frame of %zu bytes exceeds limit, disconnecting client\n", length);
+            *valid = false;
+            break;
+        }
+        if (client->in_len - start - NET_FRAME_HEADER < length) break;
+        
+        if (!net_deliver(program, client, (char*)buffer + start + NET_FRAME_HEADER,
+                         length, NET_PACKET_BINARY)) {
+            *valid = false;
+            break;
+        }
+        start += NET_FRAME_HEADER + length;
+    }
+    return start;
+}
+
+// Dispatch every complete command or frame, keep the partial tail
+static bool net_dispatch_input(NetworkProgram* program, ClientState* client) {
+    size_t start = 0;
+    bool valid = true;
+    
+    // The first byte of a connection selects its wire protocol
+    if (client->wire == NET_WIRE_UNKNOWN && client->in_len > 0) {
+        if ((unsigned char)client->in_buf[0] == NET_BINARY_MAGIC) {
+            client->wire = NET_WIRE_BINARY;
+            start = 1;
+        } else {
+            client->wire = NET_WIRE_TEXT;
+        }
+    }
+    
+    if (client->wire == NET_WIRE_BINARY) {
+        start = net_dispatch_binary(program, client, start, &valid);
+    } else {
+        start = net_dispatch_text(program, client, start, &valid);
+    }
+    
+    if (start > 0) {
+        memmove(client->in_buf, client->in_buf + start, client->in_len - start);
+        client->in_len -= start;
+    }
+    
+    // A partial command may not grow without bound
+    if (client->in_len > NET_MAX_COMMAND + NET_FRAME_HEADER) {
+        printf("Command exceeds %d bytes, disconnecting client\n", NET_MAX_COMMAND);
+        return false;
+    }
+    return valid;
+}
+
+// Feed bytes received by a completion backend through command framing
+bool net_client_input(NetworkProgram* program, ClientState* client,
+                      const void* data, size_t size) {
+    if (!program || !client) return false;
+    if (!net_reserve_input(client, size)) return false;
+    
+    memcpy(client->in_buf + client->in_len, data, size);
+    client->in_len += size;
+    return net_dispatch_input(program, client);
+}
+
+// Report disconnect and release the client slot
+static void net_disconnect_client(NetworkProgram* program, ClientState* client) {
+    NetworkEndpoint client_endpoint = {
+        .socket_fd = client->socket_fd,
+        .addr = client->addr,
+        .phantom = program->phantom,
+        .program = program
+    };
+    
+    if (program->handlers.on_disconnect) {
+        program->handlers.on_disconnect(&client_endpoint);
+    }
+    
+    net_drop_client(program, client);
+}
+
+// Write queued output until drained or the socket would block
+static bool net_flush_client(NetworkProgram* program, ClientState* client) {
+    while (client->out_head) {
+#ifdef _WIN32
+        NetChunk* head = client->out_head;
+        ssize_t written = send(client->socket_fd, head->data + head->offset,
+                               (int)(head->length - head->offset), 0);
+#else
+        // Gather several queued responses into one syscall
+        struct iovec iov[NET_MAX_IOV];
+        int count = 0;
+        for (NetChunk* chunk = client->out_head; chunk && count < NET_MAX_IOV;
+             chunk = chunk->next) {
+            iov[count].iov_base = chunk->data + chunk->offset;
+            iov[count].iov_len = chunk->length - chunk->offset;
+            count++;
+        }
+        
+        // sendmsg is writev for sockets, minus SIGPIPE on a closed peer
+        struct msghdr msg = {
+            .msg_iov = iov,
+            .msg_iovlen = (size_t)count
+        };
+        ssize_t written = sendmsg(client->socket_fd, &msg, MSG_NOSIGNAL);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        
+        client->out_head = net_consume_chunks(client->out_head, (size_t)written);
+        if (!client->out_head) client->out_tail = NULL;
+        client->out_bytes -= (size_t)written;
+    }
+    
+    net_update_interest(program, client);
+    return true;
+}
+
+// Apply responses from finished jobs, flushing each run of one client's jobs once
+static void net_drain_completions(NetworkProgram* program) {
+    ClientState* pending = NULL;
+    NetJob* job;
+    
+    net_clear_wake(program);
+    while ((job = net_next_completion(program))) {
+        ClientState* client = net_complete_job(program, job);
+        if (pending && pending != client && !net_flush_client(program, pending)) {
+            net_disconnect_client(program, pending);
+        }
+        pending = client;
+    }
+    
+    if (pending && !net_flush_client(program, pending)) {
+        net_disconnect_client(program, pending);
+    }
+}
+
+// Read from a ready client straight into its input buffer
+static void net_service_client(NetworkProgram* program, ClientState* client) {
+    if (!net_reserve_input(client, NET_BUFFER_SIZE)) {
+        printf("Failed to grow client input buffer\n");
+        net_disconnect_client(program, client);
+        return;
+    }
+    
+    ssize_t bytes_read = recv(client->socket_fd, client->in_buf + client->in_len,
+                              NET_BUFFER_SIZE, 0);
+
+    if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return;
+    }
+    
+    if (bytes_read <= 0) {
+        net_disconnect_client(program, client);
+        return;
+    }
+    
+    client->in_len += (size_t)bytes_read;
+    
+    // Responses from this read go out together in one flush
+    if (!net_dispatch_input(program, client) || !net_flush_client(program, client)) {
+        net_disconnect_client(program, client);
+    }
+}
 
+// Run the timer handler and return how long this iteration may wait: the
+// loop timeout, cut short when the handler has work due sooner
+int net_wait_timeout(NetworkProgram* program) {
+    int timeout_ms = NET_TIMEOUT_SEC * 1000 + NET_TIMEOUT_USEC / 1000;
+    
+    if (program->handlers.on_timer) {
+        int due_ms = program->handlers.on_timer(program);
+        if (due_ms >= 0 && due_ms < timeout_ms) timeout_ms = due_ms;
+    }
+    return timeout_ms;
+}
+
+// Run one select() iteration
+static void net_run_select(NetworkProgram* program) {
     fd_set readfds;
+    fd_set writefds;
+    int timeout_ms = net_wait_timeout(program);
     struct timeval tv = {
-        .tv_sec = 1,  // 1 second timeout
-        .tv_usec = 0
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000
     };
 
     // Setup file descriptors
     FD_ZERO(&readfds);
+    FD_ZERO(&writefds);
     int max_fd = program->endpoints[0].socket_fd;
     FD_SET(max_fd, &readfds);
+    if (program->wake_fd >= 0) {
+        FD_SET(program->wake_fd, &readfds);
+        if (program->wake_fd > max_fd) max_fd = program->wake_fd;
+    }
 
-    // Add active clients
-    pthread_mutex_lock(&program->clients_lock);
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        pthread_mutex_lock(&program->clients[i].lock);
-        if (program->clients[i].is_active) {
-            int fd = program->clients[i].socket_fd;
-            FD_SET(fd, &readfds);
-            if (fd > max_fd) max_fd = fd;
-        }
-        pthread_mutex_unlock(&program->clients[i].lock);
+    // Add active clients (paused clients only wait for writability)
+    for (size_t i = 0; i < program->client_count; i++) {
+        int fd = program->active_fds[i];
+        ClientState* client = &program->clients[fd];
+        if (!client->read_paused) FD_SET(fd, &readfds);
+        if (client->out_head) FD_SET(fd, &writefds);
+        if (fd > max_fd) max_fd = fd;
     }
-    pthread_mutex_unlock(&program->clients_lock);
 
     // Wait for activity with timeout
-    int activity = select(max_fd + 1, &readfds, NULL, NULL, &tv);
+    int activity = select(max_fd + 1, &readfds, &writefds, NULL, &tv);
     
     if (activity < 0) {
         if (errno != EINTR) {
@@ -289,83 +1006,92 @@ void net_run(NetworkProgram* program) {
 
     // Handle new connections
     if (FD_ISSET(program->endpoints[0].socket_fd, &readfds)) {
-        struct sockaddr_in client_addr;
-        socklen_t addr_len = sizeof(client_addr);
-        
-        int new_socket = accept(program->endpoints[0].socket_fd,
-                              (struct sockaddr*)&client_addr,
-                              &addr_len);
-
-        if (new_socket >= 0) {
-            // Set socket to non-blocking mode
-            int flags = fcntl(new_socket, F_GETFL, 0);
-            if (flags >= 0) {
-                fcntl(new_socket, F_SETFL, flags | O_NONBLOCK);
-            }
+        net_accept_client(program);
+    }
+    
+    // Deliver responses from workers
+    if (program->wake_fd >= 0 && FD_ISSET(program->wake_fd, &readfds)) {
+        net_drain_completions(program);
+    }
 
-            // Add client
-            if (net_add_client(program, new_socket, client_addr)) {
-                NetworkEndpoint client_endpoint = {
-                    .socket_fd = new_socket,
-                    .addr = client_addr,
-                    .phantom = program->phantom
-                };
-                
-                if (program->handlers.on_connect) {
-                    program->handlers.on_connect(&client_endpoint);
-                }
-            } else {
-                close(new_socket);
-            }
+    // Handle client data (walk backwards so removals don't skip entries)
+    for (size_t i = program->client_count; i-- > 0; ) {
+        int fd = program->active_fds[i];
+        ClientState* client = &program->clients[fd];
+        
+        if (FD_ISSET(fd, &writefds) && !net_flush_client(program, client)) {
+            net_disconnect_client(program, client);
+            continue;
+        }
+        if (FD_ISSET(fd, &readfds) && client->is_active) {
+            net_service_client(program, client);
         }
     }
+}
 
-    // Handle client data
-    pthread_mutex_lock(&program->clients_lock);
-    for (int i = 0; i < NET_MAX_CLIENTS; i++) {
-        pthread_mutex_lock(&program->clients[i].lock);
-        if (program->clients[i].is_active &&
-            FD_ISSET(program->clients[i].socket_fd, &readfds)) {
-            
-            char buffer[NET_BUFFER_SIZE];
-            ssize_t bytes_read = recv(program->clients[i].socket_fd,
-                                    buffer,
-                                    sizeof(buffer) - 1,
-                                    0);
-
-            if (bytes_read <= 0) {
-                // Handle disconnection
-                NetworkEndpoint client_endpoint = {
-                    .socket_fd = program->clients[i].socket_fd,
-                    .addr = program->clients[i].addr,
-                    .phantom = program->phantom
-                };
-
-                if (program->handlers.on_disconnect) {
-                    program->handlers.on_disconnect(&client_endpoint);
-                }
-                
-                net_remove_client(program, program->clients[i].socket_fd);
-            } else {
-                // Handle received data
-                NetworkEndpoint client_endpoint = {
-                    .socket_fd = program->clients[i].socket_fd,
-                    .addr = program->clients[i].addr,
-                    .phantom = program->phantom
-                };
-
-                NetworkPacket packet = {
-                    .data = buffer,
-                    .size = bytes_read,
-                    .flags = 0
-                };
-
-                if (program->handlers.on_receive) {
-                    program->handlers.on_receive(&client_endpoint, &packet);
-                }
-            }
+#ifdef __linux__
+// Run one epoll_wait() iteration, touching only ready descriptors
+static void net_run_epoll(NetworkProgram* program) {
+    struct epoll_event events[NET_MAX_EVENTS];
+    int timeout_ms = net_wait_timeout(program);
+    
+    int ready = epoll_wait(program->poll_fd, events, NET_MAX_EVENTS, timeout_ms);
+    if (ready < 0) {
+        if (errno != EINTR) {
+            perror("epoll_wait error");
+        }
+        return;
+    }
+    
+    for (int i = 0; i < ready; i++) {
+        int fd = events[i].data.fd;
+        
+        if (fd == program->endpoints[0].socket_fd) {
+            net_accept_client(program);
+            continue;
+        }
+        if (fd == program->wake_fd) {
+            net_drain_completions(program);
+            continue;
+        }
+        
+        ClientState* client = net_find_client(program, fd);
+        if (!client) continue;
+        
+        uint32_t ready_events = events[i].events;
+        if ((ready_events & EPOLLOUT) && !net_flush_client(program, client)) {
+            net_disconnect_client(program, client);
+            continue;
+        }
+        
+        // Hangups and errors surface through recv() even while paused
+        if (ready_events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            net_service_client(program, client);
         }
-        pthread_mutex_unlock(&program->clients[i].lock);
     }
-    pthread_mutex_unlock(&program->clients_lock);
-}
\ No newline at end of file
+}
+#endif
+
+// Run network program
+void net_run(NetworkProgram* program) {
+    if (!program || !program->running) return;
+
+    if (program->backend == NET_BACKEND_URING) {
+        if (net_uring_run(program)) return;
+        
+        // Kernel rejected multishot operations at runtime
+        printf("io_uring backend unsupported by kernel, falling back to epoll\n");
+        net_uring_cleanup(program);
+        program->backend = NET_BACKEND_EPOLL;
+        net_init_backend(program);
+        return;
+    }
+
+#ifdef __linux__
+    if (program->backend == NET_BACKEND_EPOLL) {
+        net_run_epoll(program);
+        return;
+    }
+#endif
+    net_run_select(program);
+}
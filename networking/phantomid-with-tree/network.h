@@ -10,14 +10,21 @@
 #else
     #include <sys/socket.h>
     #include <netinet/in.h>
+    #include <netinet/tcp.h>
     #include <arpa/inet.h>
 #endif
 
+#ifdef __linux__
+    #include <sys/epoll.h>
+#endif
+
 #include <pthread.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <stdatomic.h>
 
 // Windows compatibility defines
 #ifdef _WIN32
@@ -27,15 +34,28 @@
     #define close closesocket
 #else
     #include <unistd.h>
+    #include <sys/uio.h>
 #endif
 
 
 // Network Constants
-#define NET_MAX_CLIENTS 10
-#define NET_BUFFER_SIZE 1024
+#define NET_MAX_CLIENTS 65536       // Default client capacity per program
+#define NET_INITIAL_SLOTS 64        // Initial fd-indexed client slots
+#define NET_BUFFER_SIZE 1024        // Bytes read per recv()
+#define NET_MAX_COMMAND (1024 * 1024) // Largest buffered partial command
 #define NET_MAX_BACKLOG 5
 #define NET_TIMEOUT_SEC 1
 #define NET_TIMEOUT_USEC 0
+#define NET_MAX_EVENTS 64
+#define NET_CHUNK_SIZE 4096         // Output chunk size (small responses coalesce)
+#define NET_MAX_IOV 64              // Chunks gathered per write
+#define NET_OUTPUT_HIGH_WATER (256 * 1024) // Queued output that pauses reading
+#define NET_BINARY_MAGIC 0xB1       // First byte selecting the binary protocol
+#define NET_FRAME_HEADER 4          // Big-endian length prefix of binary frames
+#define NET_MAX_PENDING_JOBS 256    // Commands in flight per client that pause reading
+
+// Packet Flags
+#define NET_PACKET_BINARY 0x1       // Packet is one binary frame body
 
 // Network Error Codes
 typedef enum {
@@ -66,15 +86,82 @@ typedef enum {
     NET_ROLE_MAX      // Role count
 } NetworkRole;
 
-// Forward declaration
+// Event Loop Backends
+typedef enum {
+    NET_BACKEND_AUTO,   // Best available backend
+    NET_BACKEND_SELECT, // Portable select() loop
+    NET_BACKEND_EPOLL,  // Persistent epoll set (Linux)
+    NET_BACKEND_URING,  // io_uring completion ring (Linux)
+    NET_BACKEND_MAX     // Backend count
+} NetworkBackend;
+
+// Forward declarations
 typedef struct PhantomDaemon PhantomDaemon;
+typedef struct NetworkProgram NetworkProgram;
+struct NetUring;
+struct NetWorkers;
+
+// Wire Protocols (detected from the first byte of a connection)
+typedef enum {
+    NET_WIRE_UNKNOWN,   // Nothing received yet
+    NET_WIRE_TEXT,      // Newline-terminated text commands
+    NET_WIRE_BINARY     // Length-prefixed binary frames
+} NetworkWire;
+
+// Queued output chunk
+typedef struct NetChunk {
+    struct NetChunk* next;          // Next chunk in queue
+    size_t offset;                  // Bytes already written
+    size_t length;                  // Bytes filled
+    size_t capacity;                // Bytes allocated
+    char data[];                    // Chunk payload
+} NetChunk;
+
+// Lock-free multi-producer, single-consumer queue link
+typedef struct NetQueueNode {
+    struct NetQueueNode* _Atomic next;
+} NetQueueNode;
 
-// Client Connection State
+// Lock-free multi-producer, single-consumer queue (intrusive)
+typedef struct {
+    NetQueueNode* _Atomic head;     // Most recently pushed node (producers)
+    NetQueueNode* tail;             // Next node to pop (consumer)
+    NetQueueNode stub;              // Placeholder that keeps the list non-empty
+} NetQueue;
+
+// Command handed to a worker and returned to its reactor with the responses
+typedef struct NetJob {
+    NetQueueNode node;              // Queue link (must stay first)
+    NetworkProgram* program;        // Reactor that owns the connection
+    int socket_fd;                  // Client descriptor
+    uint32_t generation;            // Client generation when queued
+    struct sockaddr_in addr;        // Client address
+    uint32_t flags;                 // Packet flags
+    NetChunk* out_head;             // Responses written by the handler
+    NetChunk* out_tail;             // Newest response chunk
+    size_t out_bytes;               // Response bytes
+    size_t size;                    // Command bytes
+    char data[];                    // Command (NUL-terminated)
+} NetJob;
+
+// Client Connection State (slot in the fd-indexed client table)
 typedef struct {
-    pthread_mutex_t lock;           // State mutex
     bool is_active;                 // Active flag
     int socket_fd;                  // Socket descriptor
+    uint32_t generation;            // Bumped for every connection using this slot
+    size_t active_index;            // Position in the active list
     struct sockaddr_in addr;        // Client address
+    char* in_buf;                   // Buffered input awaiting a newline
+    size_t in_len;                  // Buffered bytes
+    size_t in_cap;                  // Buffer capacity
+    NetworkWire wire;               // Detected wire protocol
+    NetChunk* out_head;             // Queued output (oldest first)
+    NetChunk* out_tail;             // Newest output chunk
+    size_t out_bytes;               // Unsent bytes, including in flight
+    size_t high_water;              // Output level that pauses reading
+    bool read_paused;               // Reading paused for backpressure
+    size_t pending_jobs;            // Commands queued to workers
+    uint32_t events;                // Registered epoll events
 } ClientState;
 
 // Network Endpoint
@@ -84,9 +171,12 @@ typedef struct {
     uint16_t port;                  // Port number
     NetworkProtocol protocol;       // Protocol type
     NetworkRole role;               // Endpoint role
+    bool reuse_port;                // Share port via SO_REUSEPORT
     int socket_fd;                  // Socket descriptor
     struct sockaddr_in addr;        // Socket address
     PhantomDaemon* phantom;         // Phantom daemon reference
+    NetworkProgram* program;        // Owning program (client endpoints)
+    NetJob* job;                    // Command being answered on a worker
 } NetworkEndpoint;
 
 // Network Packet
@@ -97,33 +187,84 @@ typedef struct {
 } NetworkPacket;
 
 // Network Program
-typedef struct {
+struct NetworkProgram {
     NetworkEndpoint* endpoints;      // Endpoint array
     size_t count;                   // Endpoint count
-    ClientState clients[NET_MAX_CLIENTS]; // Client states
-    pthread_mutex_t clients_lock;    // Clients mutex
+    ClientState* clients;            // Client slots indexed by fd
+    size_t client_slots;             // Allocated slots
+    int* active_fds;                 // Dense list of active client fds
+    size_t client_count;             // Active clients
+    size_t max_clients;              // Capacity (0 selects NET_MAX_CLIENTS)
+    size_t output_high_water;        // Per-client high-water mark (0 = default)
     volatile bool running;           // Running flag
+    NetworkBackend backend;          // Event loop backend
+    int poll_fd;                     // epoll descriptor (-1 if unused)
+    struct NetUring* uring;          // io_uring state (NULL if unused)
+    struct NetWorkers* workers;      // Command workers (NULL runs commands inline)
+    NetQueue completions;            // Jobs finished by workers
+    atomic_bool wake_pending;        // Wake already signalled for completions
+    int wake_fd;                     // Readable while completions wait (-1 if unused)
+    int wake_signal_fd;              // Written by workers to wake the reactor
     struct {
         void (*on_receive)(NetworkEndpoint*, NetworkPacket*);  // Data handler
         void (*on_connect)(NetworkEndpoint*);                  // Connect handler
         void (*on_disconnect)(NetworkEndpoint*);               // Disconnect handler
+        int (*on_timer)(NetworkProgram*);                      // Due work; returns ms until next due
     } handlers;
     PhantomDaemon* phantom;         // Phantom daemon reference
-} NetworkProgram;
+};
 
 // Core Network Functions
 bool net_init(NetworkEndpoint* endpoint);
 void net_close(NetworkEndpoint* endpoint);
 ssize_t net_send(NetworkEndpoint* endpoint, NetworkPacket* packet);
+ssize_t net_send_frame(NetworkEndpoint* endpoint, NetworkPacket* packet);
 ssize_t net_receive(NetworkEndpoint* endpoint, NetworkPacket* packet);
 void net_run(NetworkProgram* program);
+bool net_add_client(NetworkProgram* program, int socket_fd, struct sockaddr_in addr);
+void net_remove_client(NetworkProgram* program, int socket_fd);
+ClientState* net_find_client(NetworkProgram* program, int socket_fd);
+bool net_client_input(NetworkProgram* program, ClientState* client,
+                      const void* data, size_t size);
+bool net_queue_output(ClientState* client, const void* data, size_t size);
+NetChunk* net_consume_chunks(NetChunk* head, size_t bytes);
+void net_free_chunks(NetChunk* chunk);
+bool net_update_backpressure(ClientState* client);
+bool net_append_chunks(NetChunk** head, NetChunk** tail, size_t* bytes,
+                       const void* data, size_t size);
+ClientState* net_complete_job(NetworkProgram* program, NetJob* job);
 
 // Utility Functions
 bool net_is_port_in_use(uint16_t port);
 bool net_release_port(uint16_t port);
+bool net_pin_thread(size_t cpu);
 void net_init_client_state(ClientState* state);
 void net_cleanup_client_state(ClientState* state);
 void net_init_program(NetworkProgram* program);
 void net_cleanup_program(NetworkProgram* program);
+const char* net_backend_name(NetworkBackend backend);
+bool net_backend_from_name(const char* name, NetworkBackend* backend);
+int net_wait_timeout(NetworkProgram* program);
+
+// io_uring Backend (network_uring.c)
+bool net_uring_init(NetworkProgram* program);
+void net_uring_cleanup(NetworkProgram* program);
+bool net_uring_run(NetworkProgram* program);
+
+// Lock-free Queue (network_worker.c)
+void net_queue_init(NetQueue* queue);
+void net_queue_push(NetQueue* queue, NetQueueNode* node);
+NetQueueNode* net_queue_pop(NetQueue* queue);
+
+// Worker Pool (network_worker.c)
+struct NetWorkers* net_create_workers(size_t count);
+void net_destroy_workers(struct NetWorkers* workers);
+size_t net_worker_count(const struct NetWorkers* workers);
+bool net_submit_job(NetworkProgram* program, ClientState* client,
+                    const void* data, size_t size, uint32_t flags);
+NetJob* net_next_completion(NetworkProgram* program);
+bool net_init_wake(NetworkProgram* program);
+void net_cleanup_wake(NetworkProgram* program);
+void net_clear_wake(NetworkProgram* program);
 
 #endif // NETWORK_H
\ No newline at end of file
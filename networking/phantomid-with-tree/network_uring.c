@@ -0,0 +1,695 @@
+#include "network.h"
+
+#if defined(__linux__) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #include <linux/io_uring.h>
+        #ifdef IORING_RECV_MULTISHOT
+            #define NET_HAVE_URING 1
+        #endif
+    #endif
+#endif
+
+#ifdef NET_HAVE_URING
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+// io_uring sizing
+#define URING_ENTRIES 256
+#define URING_BUF_COUNT 256          // Provided receive buffers (power of two)
+#define URING_BUF_GROUP 0            // Provided buffer group id
+
+// Operation tags packed into user_data (sends carry their UringSend pointer)
+#define URING_OP_ACCEPT 1ULL
+#define URING_OP_RECV   2ULL
+#define URING_OP_WAKE   3ULL
+#define URING_IGNORED   0ULL          // Completions nobody waits for (cancels)
+#define URING_TAG_SHIFT 62
+#define URING_GEN_SHIFT 32
+
+// In-flight gathered send; owns the chunks it detached from the client queue
+typedef struct UringSend {
+    struct UringSend* prev;         // Links in NetUring.sends until freed
+    struct UringSend* next;
+    int fd;
+    uint32_t gen;
+    NetChunk* chunks;
+    struct iovec iov[NET_MAX_IOV];
+    struct msghdr msg;
+} UringSend;
+
+// Per-descriptor connection state
+typedef struct {
+    uint32_t gen;                   // Bumped on every accept/close
+    bool open;                      // Connection is live
+    bool recv_armed;                // A receive is outstanding
+    UringSend* send;                // Send in flight (at most one)
+} UringConn;
+
+// io_uring backend state
+struct NetUring {
+    int ring_fd;
+
+    // Submission queue
+    void* sq_ptr;
+    size_t sq_size;
+    _Atomic unsigned* sq_head;
+    _Atomic unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned sq_entries;
+    unsigned to_submit;
+
+    // Completion queue
+    void* cq_ptr;
+    size_t cq_size;
+    _Atomic unsigned* cq_head;
+    _Atomic unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+
+    // Provided receive buffers
+    struct io_uring_buf_ring* buf_ring;
+    size_t buf_ring_size;
+    char* buffers;
+    bool recv_multishot;
+
+    // Connections indexed by fd
+    UringConn* conns;
+    size_t conn_cap;
+
+    // Every send not yet freed, including ones orphaned by a disconnect
+    UringSend* sends;
+};
+
+static int uring_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                       unsigned flags, void* arg, size_t arg_size) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                        flags, arg, arg_size);
+}
+
+static int uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static uint64_t uring_pack(uint64_t op, uint32_t gen, int fd) {
+    return (op << URING_TAG_SHIFT) |
+           ((uint64_t)(gen & 0x3fffffff) << URING_GEN_SHIFT) |
+           (uint32_t)fd;
+}
+
+// Look up (and grow to) connection state for fd
+static UringConn* uring_conn(struct NetUring* ring, int fd) {
+    if (fd < 0) return NULL;
+
+    if ((size_t)fd >= ring->conn_cap) {
+        size_t cap = ring->conn_cap ? ring->conn_cap : 64;
+        while (cap <= (size_t)fd) cap *= 2;
+
+        UringConn* conns = realloc(ring->conns, cap * sizeof(UringConn));
+        if (!conns) return NULL;
+        memset(&conns[ring->conn_cap], 0, (cap - ring->conn_cap) * sizeof(UringConn));
+        ring->conns = conns;
+        ring->conn_cap = cap;
+    }
+    return &ring->conns[fd];
+}
+
+// Flush queued submissions without waiting
+static int uring_submit(struct NetUring* ring) {
+    if (ring->to_submit == 0) return 0;
+
+    int ret = uring_enter(ring->ring_fd, ring->to_submit, 0, 0, NULL, 0);
+    if (ret > 0) ring->to_submit -= (unsigned)ret;
+    return ret;
+}
+
+// Get next free submission entry
+static struct io_uring_sqe* uring_get_sqe(struct NetUring* ring) {
+    unsigned tail = atomic_load_explicit(ring->sq_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(ring->sq_head, memory_order_acquire);
+
+    if (tail - head >= ring->sq_entries) {
+        if (uring_submit(ring) < 0) return NULL;
+        head = atomic_load_explicit(ring->sq_head, memory_order_acquire);
+        if (tail - head >= ring->sq_entries) return NULL;
+    }
+
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sq_array[index] = index;
+    atomic_store_explicit(ring->sq_tail, tail + 1, memory_order_release);
+    ring->to_submit++;
+    return sqe;
+}
+
+// Queue multishot accept on the listener
+static bool uring_arm_accept(struct NetUring* ring, int listen_fd) {
+    struct io_uring_sqe* sqe = uring_get_sqe(ring);
+    if (!sqe) return false;
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->user_data = uring_pack(URING_OP_ACCEPT, 0, listen_fd);
+    return true;
+}
+
+// Queue (multishot) receive into the provided buffer group
+static bool uring_arm_recv(struct NetUring* ring, int fd, uint32_t gen) {
+    struct io_uring_sqe* sqe = uring_get_sqe(ring);
+    if (!sqe) return false;
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUF_GROUP;
+    sqe->ioprio = ring->recv_multishot ? IORING_RECV_MULTISHOT : 0;
+    sqe->user_data = uring_pack(URING_OP_RECV, gen, fd);
+    return true;
+}
+
+// Point the send's iovecs at its unsent bytes and queue a SENDMSG
+static bool uring_arm_send(struct NetUring* ring, UringSend* op) {
+    size_t count = 0;
+    for (NetChunk* chunk = op->chunks; chunk; chunk = chunk->next) {
+        op->iov[count].iov_base = chunk->data + chunk->offset;
+        op->iov[count].iov_len = chunk->length - chunk->offset;
+        count++;
+    }
+    op->msg.msg_iov = op->iov;
+    op->msg.msg_iovlen = count;
+
+    struct io_uring_sqe* sqe = uring_get_sqe(ring);
+    if (!sqe) return false;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = op->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&op->msg;
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = (uint64_t)(uintptr_t)op;
+    return true;
+}
+
+// Cancel an outstanding multishot receive (reading paused)
+static void uring_cancel_recv(struct NetUring* ring, int fd, uint32_t gen) {
+    struct io_uring_sqe* sqe = uring_get_sqe(ring);
+    if (!sqe) return;
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = uring_pack(URING_OP_RECV, gen, fd);
+    sqe->user_data = URING_IGNORED;
+}
+
+// Queue a multishot poll on the worker wake descriptor
+static bool uring_arm_wake(struct NetUring* ring, int wake_fd) {
+    struct io_uring_sqe* sqe = uring_get_sqe(ring);
+    if (!sqe) return false;
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = wake_fd;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = uring_pack(URING_OP_WAKE, 0, wake_fd);
+    return true;
+}
+
+static void uring_free_send(struct NetUring* ring, UringSend* op) {
+    if (op->prev) op->prev->next = op->next;
+    else ring->sends = op->next;
+    if (op->next) op->next->prev = op->prev;
+    net_free_chunks(op->chunks);
+    free(op);
+}
+
+// Move queued client output into a gathered send, one in flight per fd
+static bool uring_flush(NetworkProgram* program, int fd) {
+    struct NetUring* ring = program->uring;
+    UringConn* conn = uring_conn(ring, fd);
+    ClientState* client = net_find_client(program, fd);
+    if (!conn || !client || conn->send || !client->out_head) return true;
+
+    UringSend* op = calloc(1, sizeof(UringSend));
+    if (!op) return false;
+    op->fd = fd;
+    op->gen = conn->gen;
+    op->next = ring->sends;
+    if (ring->sends) ring->sends->prev = op;
+    ring->sends = op;
+
+    // Detach up to NET_MAX_IOV chunks; the op owns them until completion
+    NetChunk* last = client->out_head;
+    for (int count = 1; count < NET_MAX_IOV && last->next; count++) {
+        last = last->next;
+    }
+    op->chunks = client->out_head;
+    client->out_head = last->next;
+    if (!client->out_head) client->out_tail = NULL;
+    last->next = NULL;
+
+    conn->send = op;
+    if (!uring_arm_send(ring, op)) {
+        conn->send = NULL;
+        uring_free_send(ring, op);
+        return false;
+    }
+    return true;
+}
+
+// Apply backpressure: stop receiving while output is piling up
+static void uring_update_backpressure(NetworkProgram* program, int fd) {
+    struct NetUring* ring = program->uring;
+    UringConn* conn = uring_conn(ring, fd);
+    ClientState* client = net_find_client(program, fd);
+    if (!conn || !client) return;
+
+    bool changed = net_update_backpressure(client);
+    if (changed && client->read_paused && conn->recv_armed && ring->recv_multishot) {
+        uring_cancel_recv(ring, fd, conn->gen);
+    } else if (!client->read_paused && !conn->recv_armed) {
+        conn->recv_armed = uring_arm_recv(ring, fd, conn->gen);
+    }
+}
+
+// Hand a receive buffer back to the kernel
+static void uring_recycle_buffer(struct NetUring* ring, uint16_t bid) {
+    unsigned short tail = ring->buf_ring->tail;
+    struct io_uring_buf* buf = &ring->buf_ring->bufs[tail & (URING_BUF_COUNT - 1)];
+
+    buf->addr = (uint64_t)(uintptr_t)(ring->buffers + (size_t)bid * NET_BUFFER_SIZE);
+    buf->len = NET_BUFFER_SIZE;
+    buf->bid = bid;
+    atomic_store_explicit((_Atomic unsigned short*)&ring->buf_ring->tail,
+                          (unsigned short)(tail + 1), memory_order_release);
+}
+
+// Tear down a connection after EOF or error
+static void uring_disconnect(NetworkProgram* program, int fd) {
+    struct NetUring* ring = program->uring;
+    UringConn* conn = uring_conn(ring, fd);
+
+    if (conn && conn->open) {
+        conn->open = false;
+        conn->gen++;
+        conn->recv_armed = false;
+        conn->send = NULL;  // Freed when its stale completion arrives
+
+        // The peer is usually gone by now, so use the address saved at accept
+        ClientState* client = net_find_client(program, fd);
+        NetworkEndpoint client_endpoint = {
+            .socket_fd = fd,
+            .phantom = program->phantom,
+            .program = program
+        };
+        if (client) client_endpoint.addr = client->addr;
+
+        if (program->handlers.on_disconnect) {
+            program->handlers.on_disconnect(&client_endpoint);
+        }
+    }
+
+    // Completes any receive still armed on the socket before the fd closes
+    shutdown(fd, SHUT_RDWR);
+    net_remove_client(program, fd);
+}
+
+static void uring_handle_accept(NetworkProgram* program, struct io_uring_cqe* cqe) {
+    struct NetUring* ring = program->uring;
+
+    if (!(cqe->flags & IORING_CQE_F_MORE)) {
+        uring_arm_accept(ring, program->endpoints[0].socket_fd);
+    }
+    if (cqe->res < 0) {
+        if (cqe->res != -EINTR && cqe->res != -EAGAIN) {
+            fprintf(stderr, "io_uring accept failed: %s\n", strerror(-cqe->res));
+        }
+        return;
+    }
+
+    int fd = cqe->res;
+    struct sockaddr_in client_addr;
+    socklen_t addr_len = sizeof(client_addr);
+    memset(&client_addr, 0, sizeof(client_addr));
+    getpeername(fd, (struct sockaddr*)&client_addr, &addr_len);
+
+    UringConn* conn = uring_conn(ring, fd);
+    if (!conn || !net_add_client(program, fd, client_addr)) {
+        close(fd);
+        return;
+    }
+
+    conn->open = true;
+    conn->gen++;
+    conn->recv_armed = false;
+    conn->send = NULL;
+
+    NetworkEndpoint client_endpoint = {
+        .socket_fd = fd,
+        .addr = client_addr,
+        .phantom = program->phantom,
+        .program = program
+    };
+    if (program->handlers.on_connect) {
+        program->handlers.on_connect(&client_endpoint);
+    }
+
+    conn->recv_armed = uring_arm_recv(ring, fd, conn->gen);
+    if (!conn->recv_armed) {
+        uring_disconnect(program, fd);
+    }
+}
+
+static void uring_handle_recv(NetworkProgram* program, struct io_uring_cqe* cqe) {
+    struct NetUring* ring = program->uring;
+    int fd = (int)(uint32_t)cqe->user_data;
+    uint32_t gen = (uint32_t)(cqe->user_data >> URING_GEN_SHIFT) & 0x3fffffff;
+    UringConn* conn = uring_conn(ring, fd);
+    bool live = conn && conn->open && (conn->gen & 0x3fffffff) == gen;
+
+    bool has_buffer = (cqe->flags & IORING_CQE_F_BUFFER) != 0;
+    uint16_t bid = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+
+    bool framed = true;
+    if (live && cqe->res > 0 && has_buffer) {
+        char* data = ring->buffers + (size_t)bid * NET_BUFFER_SIZE;
+        framed = net_client_input(program, net_find_client(program, fd),
+                                  data, (size_t)cqe->res);
+    }
+
+    if (has_buffer) {
+        uring_recycle_buffer(ring, bid);
+    }
+    if (!live) return;
+    if (!(cqe->flags & IORING_CQE_F_MORE)) conn->recv_armed = false;
+
+    // Kernel without multishot recv: degrade to one-shot receives
+    if (cqe->res == -EINVAL && ring->recv_multishot) {
+        ring->recv_multishot = false;
+        conn->recv_armed = uring_arm_recv(ring, fd, conn->gen);
+        return;
+    }
+
+    // Receive cancelled while reading is paused
+    if (cqe->res == -ECANCELED) {
+        uring_update_backpressure(program, fd);
+        return;
+    }
+
+    if (!framed || cqe->res == 0 ||
+        (cqe->res < 0 && cqe->res != -ENOBUFS && cqe->res != -EINTR)) {
+        uring_disconnect(program, fd);
+        return;
+    }
+
+    // Responses from this read go out with the next submission batch
+    if (!uring_flush(program, fd)) {
+        uring_disconnect(program, fd);
+        return;
+    }
+    uring_update_backpressure(program, fd);
+}
+
+// Abandon a connection whose send failed
+static void uring_fail_send(NetworkProgram* program, UringConn* conn, UringSend* op) {
+    int fd = op->fd;
+
+    conn->send = NULL;
+    uring_free_send(program->uring, op);
+
+    // An armed receive observes the shutdown and disconnects for us
+    shutdown(fd, SHUT_RDWR);
+    if (!conn->recv_armed) {
+        uring_disconnect(program, fd);
+    }
+}
+
+static void uring_handle_send(NetworkProgram* program, struct io_uring_cqe* cqe) {
+    struct NetUring* ring = program->uring;
+    UringSend* op = (UringSend*)(uintptr_t)cqe->user_data;
+    int fd = op->fd;
+    UringConn* conn = uring_conn(ring, fd);
+
+    if (!conn || !conn->open || conn->gen != op->gen || conn->send != op) {
+        uring_free_send(ring, op);
+        return;
+    }
+
+    if (cqe->res < 0 && cqe->res != -EAGAIN && cqe->res != -EINTR) {
+        uring_fail_send(program, conn, op);
+        return;
+    }
+
+    size_t written = cqe->res > 0 ? (size_t)cqe->res : 0;
+    ClientState* client = net_find_client(program, fd);
+    if (client) client->out_bytes -= written;
+
+    op->chunks = net_consume_chunks(op->chunks, written);
+    if (op->chunks) {
+        // Short write, send the remainder
+        if (!uring_arm_send(ring, op)) uring_fail_send(program, conn, op);
+        return;
+    }
+
+    conn->send = NULL;
+    uring_free_send(ring, op);
+
+    if (!uring_flush(program, fd)) {
+        uring_disconnect(program, fd);
+        return;
+    }
+    uring_update_backpressure(program, fd);
+}
+
+// Move responses from finished worker jobs into their connections' sends
+static void uring_handle_wake(NetworkProgram* program, struct io_uring_cqe* cqe) {
+    if (!(cqe->flags & IORING_CQE_F_MORE)) {
+        uring_arm_wake(program->uring, program->wake_fd);
+    }
+
+    net_clear_wake(program);
+    NetJob* job;
+    while ((job = net_next_completion(program))) {
+        ClientState* client = net_complete_job(program, job);
+        if (!client) continue;
+
+        int fd = client->socket_fd;
+        if (!uring_flush(program, fd)) {
+            uring_disconnect(program, fd);
+            continue;
+        }
+        uring_update_backpressure(program, fd);
+    }
+}
+
+// Map rings shared with the kernel
+static bool uring_map(struct NetUring* ring, struct io_uring_params* params) {
+    ring->sq_size = params->sq_off.array + params->sq_entries * sizeof(unsigned);
+    ring->cq_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+
+    if (params->features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_size > ring->sq_size) ring->sq_size = ring->cq_size;
+        ring->cq_size = ring->sq_size;
+    }
+
+    ring->sq_ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == MAP_FAILED) {
+        ring->sq_ptr = NULL;
+        return false;
+    }
+
+    if (params->features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ptr = ring->sq_ptr;
+    } else {
+        ring->cq_ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ptr == MAP_FAILED) {
+            ring->cq_ptr = NULL;
+            return false;
+        }
+    }
+
+    ring->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        return false;
+    }
+
+    char* sq = ring->sq_ptr;
+    ring->sq_head = (_Atomic unsigned*)(sq + params->sq_off.head);
+    ring->sq_tail = (_Atomic unsigned*)(sq + params->sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + params->sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + params->sq_off.array);
+    ring->sq_entries = params->sq_entries;
+
+    char* cq = ring->cq_ptr;
+    ring->cq_head = (_Atomic unsigned*)(cq + params->cq_off.head);
+    ring->cq_tail = (_Atomic unsigned*)(cq + params->cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + params->cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params->cq_off.cqes);
+    return true;
+}
+
+// Register the provided receive buffer ring
+static bool uring_setup_buffers(struct NetUring* ring) {
+    ring->buf_ring_size = URING_BUF_COUNT * sizeof(struct io_uring_buf);
+    ring->buf_ring = mmap(NULL, ring->buf_ring_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring->buf_ring == MAP_FAILED) {
+        ring->buf_ring = NULL;
+        return false;
+    }
+
+    ring->buffers = malloc((size_t)URING_BUF_COUNT * NET_BUFFER_SIZE);
+    if (!ring->buffers) return false;
+
+    struct io_uring_buf_reg reg = {
+        .ring_addr = (uint64_t)(uintptr_t)ring->buf_ring,
+        .ring_entries = URING_BUF_COUNT,
+        .bgid = URING_BUF_GROUP
+    };
+    if (uring_register(ring->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        return false;
+    }
+
+    ring->buf_ring->tail = 0;
+    for (uint16_t bid = 0; bid < URING_BUF_COUNT; bid++) {
+        uring_recycle_buffer(ring, bid);
+    }
+    return true;
+}
+
+void net_uring_cleanup(NetworkProgram* program) {
+    if (!program || !program->uring) return;
+    struct NetUring* ring = program->uring;
+
+    if (ring->ring_fd >= 0) close(ring->ring_fd);
+    if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ptr && ring->cq_ptr != ring->sq_ptr) munmap(ring->cq_ptr, ring->cq_size);
+    if (ring->sq_ptr) munmap(ring->sq_ptr, ring->sq_size);
+    if (ring->buf_ring) munmap(ring->buf_ring, ring->buf_ring_size);
+    free(ring->buffers);
+
+    // Ring is closed, so every outstanding send can be released, including
+    // those a disconnect left for completions that will never be reaped
+    while (ring->sends) uring_free_send(ring, ring->sends);
+    free(ring->conns);
+    free(ring);
+    program->uring = NULL;
+}
+
+bool net_uring_init(NetworkProgram* program) {
+    if (!program || !program->endpoints || program->count == 0) return false;
+
+    struct NetUring* ring = calloc(1, sizeof(struct NetUring));
+    if (!ring) return false;
+    ring->ring_fd = -1;
+    ring->recv_multishot = true;
+    program->uring = ring;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CLAMP;
+
+    ring->ring_fd = uring_setup(URING_ENTRIES, &params);
+    if (ring->ring_fd < 0) {
+        perror("io_uring_setup failed");
+        net_uring_cleanup(program);
+        return false;
+    }
+
+    // Bounded waits need IORING_ENTER_EXT_ARG
+    if (!(params.features & IORING_FEAT_EXT_ARG) ||
+        !uring_map(ring, &params) ||
+        !uring_setup_buffers(ring) ||
+        !uring_arm_accept(ring, program->endpoints[0].socket_fd) ||
+        (program->wake_fd >= 0 && !uring_arm_wake(ring, program->wake_fd))) {
+        fprintf(stderr, "io_uring features unavailable on this kernel\n");
+        net_uring_cleanup(program);
+        return false;
+    }
+
+    return true;
+}
+
+// Submit pending work, wait for completions and dispatch them
+bool net_uring_run(NetworkProgram* program) {
+    struct NetUring* ring = program->uring;
+
+    int timeout_ms = net_wait_timeout(program);
+    struct __kernel_timespec ts = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_nsec = (long long)(timeout_ms % 1000) * 1000000
+    };
+    struct io_uring_getevents_arg arg = {
+        .ts = (uint64_t)(uintptr_t)&ts
+    };
+
+    int ret = uring_enter(ring->ring_fd, ring->to_submit, 1,
+                          IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                          &arg, sizeof(arg));
+    if (ret < 0 && errno != EINTR && errno != ETIME && errno != EBUSY) {
+        perror("io_uring_enter error");
+        return true;
+    }
+    if (ret > 0) ring->to_submit -= (unsigned)ret;
+
+    unsigned head = atomic_load_explicit(ring->cq_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(ring->cq_tail, memory_order_acquire);
+
+    while (head != tail) {
+        struct io_uring_cqe cqe = ring->cqes[head & *ring->cq_mask];
+        head++;
+        atomic_store_explicit(ring->cq_head, head, memory_order_release);
+
+        if (cqe.user_data == URING_IGNORED) {
+            // Outcome of a cancel arrives on the cancelled receive
+        } else if ((cqe.user_data >> URING_TAG_SHIFT) == URING_OP_ACCEPT) {
+            // Kernel lacks multishot accept: let the caller fall back
+            if (cqe.res == -EINVAL) return false;
+            uring_handle_accept(program, &cqe);
+        } else if ((cqe.user_data >> URING_TAG_SHIFT) == URING_OP_RECV) {
+            uring_handle_recv(program, &cqe);
+        } else if ((cqe.user_data >> URING_TAG_SHIFT) == URING_OP_WAKE) {
+            uring_handle_wake(program, &cqe);
+        } else {
+            uring_handle_send(program, &cqe);
+        }
+
+        tail = atomic_load_explicit(ring->cq_tail, memory_order_acquire);
+    }
+
+    return true;
+}
+
+#else
+
+bool net_uring_init(NetworkProgram* program) {
+    (void)program;
+    return false;
+}
+
+void net_uring_cleanup(NetworkProgram* program) {
+    (void)program;
+}
+
+bool net_uring_run(NetworkProgram* program) {
+    (void)program;
+    return false;
+}
+#endif // NET_HAVE_URING
@@ -0,0 +1,323 @@
+#include "network.h"
+
+#ifndef _WIN32
+    #include <sched.h>
+    #include <semaphore.h>
+#endif
+#ifdef __linux__
+    #include <sys/eventfd.h>
+#endif
+
+// Initialize an empty queue
+void net_queue_init(NetQueue* queue) {
+    atomic_store_explicit(&queue->stub.next, NULL, memory_order_relaxed);
+    atomic_store_explicit(&queue->head, &queue->stub, memory_order_relaxed);
+    queue->tail = &queue->stub;
+}
+
+// Push a node (any thread): one exchange, then link the previous head
+void net_queue_push(NetQueue* queue, NetQueueNode* node) {
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    NetQueueNode* prev = atomic_exchange_explicit(&queue->head, node, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, node, memory_order_release);
+}
+
+// Pop the oldest node (consumer thread only); NULL when empty or when
+// a producer has swapped the head but not linked its node in yet
+NetQueueNode* net_queue_pop(NetQueue* queue) {
+    NetQueueNode* tail = queue->tail;
+    NetQueueNode* next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+    if (tail == &queue->stub) {
+        if (!next) return NULL;
+        queue->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&next->next, memory_order_acquire);
+    }
+
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+
+    if (tail != atomic_load_explicit(&queue->head, memory_order_acquire)) return NULL;
+
+    // Last real node: park the stub behind it so it can be handed out
+    net_queue_push(queue, &queue->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next) {
+        queue->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+// Free a job and any responses it still owns
+static void net_free_job(NetJob* job) {
+    net_free_chunks(job->out_head);
+    free(job);
+}
+
+// Take the next finished job on the reactor thread
+NetJob* net_next_completion(NetworkProgram* program) {
+    return (NetJob*)net_queue_pop(&program->completions);
+}
+
+#ifndef _WIN32
+
+// Worker thread state (one cache line apart so producers don't false-share)
+typedef struct {
+    _Alignas(64) NetQueue queue;    // Jobs for connections mapped to this worker
+    sem_t ready;                    // Posted once per queued job
+    pthread_t thread;               // Worker thread
+    bool started;                   // Thread was created
+    struct NetWorkers* pool;        // Owning pool
+} NetWorker;
+
+// Worker pool shared by all reactors
+struct NetWorkers {
+    NetWorker* threads;             // Worker array
+    size_t count;                   // Worker count
+    atomic_bool stopping;           // Set when the pool shuts down
+};
+
+// Create the wake descriptor workers use to signal finished jobs
+bool net_init_wake(NetworkProgram* program) {
+    net_queue_init(&program->completions);
+    atomic_store(&program->wake_pending, false);
+
+#ifdef __linux__
+    program->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    program->wake_signal_fd = program->wake_fd;
+    if (program->wake_fd < 0) {
+        perror("eventfd failed");
+        return false;
+    }
+#else
+    int fds[2];
+    if (pipe(fds) < 0) {
+        perror("pipe failed");
+        program->wake_fd = -1;
+        program->wake_signal_fd = -1;
+        return false;
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    program->wake_fd = fds[0];
+    program->wake_signal_fd = fds[1];
+#endif
+    return true;
+}
+
+// Drop unclaimed completions and close the wake descriptor
+void net_cleanup_wake(NetworkProgram* program) {
+    NetJob* job;
+    while ((job = net_next_completion(program))) {
+        net_free_job(job);
+    }
+
+    if (program->wake_signal_fd >= 0 && program->wake_signal_fd != program->wake_fd) {
+        close(program->wake_signal_fd);
+    }
+    if (program->wake_fd >= 0) {
+        close(program->wake_fd);
+    }
+    program->wake_fd = -1;
+    program->wake_signal_fd = -1;
+}
+
+// Consume the wake signal before draining completions
+void net_clear_wake(NetworkProgram* program) {
+    char drain[64];
+    while (read(program->wake_fd, drain, sizeof(drain)) > 0) {
+        // eventfd resets in one read, a pipe may need several
+    }
+
+    // Completions pushed after this store signal again
+    atomic_store(&program->wake_pending, false);
+}
+
+// Hand a finished job back to its reactor, waking it at most once per drain
+static void net_post_completion(NetJob* job) {
+    NetworkProgram* program = job->program;
+
+    net_queue_push(&program->completions, &job->node);
+    if (!atomic_exchange(&program->wake_pending, true)) {
+        uint64_t one = 1;
+        if (write(program->wake_signal_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            perror("wake write failed");
+        }
+    }
+}
+
+// Run one command; responses collect in the job
+static void net_run_job(NetJob* job) {
+    NetworkProgram* program = job->program;
+    NetworkEndpoint client_endpoint = {
+        .socket_fd = job->socket_fd,
+        .addr = job->addr,
+        .phantom = program->phantom,
+        .program = program,
+        .job = job
+    };
+    NetworkPacket packet = {
+        .data = job->data,
+        .size = job->size,
+        .flags = job->flags
+    };
+
+    program->handlers.on_receive(&client_endpoint, &packet);
+    net_post_completion(job);
+}
+
+static void* net_worker_main(void* arg) {
+    NetWorker* worker = arg;
+
+    for (;;) {
+        if (sem_wait(&worker->ready) < 0) continue;  // EINTR
+        if (atomic_load(&worker->pool->stopping)) break;
+
+        // Our job is fully pushed, but an older push may still be linking in
+        NetQueueNode* node;
+        while (!(node = net_queue_pop(&worker->queue))) {
+            sched_yield();
+        }
+        net_run_job((NetJob*)node);
+    }
+    return NULL;
+}
+
+// Start a pool of count worker threads
+struct NetWorkers* net_create_workers(size_t count) {
+    if (count == 0) return NULL;
+
+    struct NetWorkers* pool = calloc(1, sizeof(struct NetWorkers));
+    if (!pool) return NULL;
+
+    pool->threads = aligned_alloc(_Alignof(NetWorker), count * sizeof(NetWorker));
+    if (!pool->threads) {
+        free(pool);
+        return NULL;
+    }
+    atomic_store(&pool->stopping, false);
+
+    for (size_t i = 0; i < count; i++) {
+        NetWorker* worker = &pool->threads[i];
+        net_queue_init(&worker->queue);
+        sem_init(&worker->ready, 0, 0);
+        worker->pool = pool;
+        worker->started = pthread_create(&worker->thread, NULL, net_worker_main, worker) == 0;
+        pool->count = i + 1;
+
+        if (!worker->started) {
+            perror("Failed to start worker thread");
+            net_destroy_workers(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+// Stop and join the workers (reactors must no longer submit)
+void net_destroy_workers(struct NetWorkers* workers) {
+    if (!workers) return;
+
+    atomic_store(&workers->stopping, true);
+    for (size_t i = 0; i < workers->count; i++) {
+        sem_post(&workers->threads[i].ready);
+    }
+
+    for (size_t i = 0; i < workers->count; i++) {
+        NetWorker* worker = &workers->threads[i];
+        if (worker->started) {
+            pthread_join(worker->thread, NULL);
+        }
+
+        NetQueueNode* node;
+        while ((node = net_queue_pop(&worker->queue))) {
+            net_free_job((NetJob*)node);
+        }
+        sem_destroy(&worker->ready);
+    }
+
+    free(workers->threads);
+    free(workers);
+}
+
+size_t net_worker_count(const struct NetWorkers* workers) {
+    return workers ? workers->count : 0;
+}
+
+// Copy a framed command into a job for the connection's worker
+bool net_submit_job(NetworkProgram* program, ClientState* client,
+                    const void* data, size_t size, uint32_t flags) {
+    struct NetWorkers* workers = program->workers;
+
+    NetJob* job = malloc(sizeof(NetJob) + size + 1);
+    if (!job) return false;
+
+    job->program = program;
+    job->socket_fd = client->socket_fd;
+    job->generation = client->generation;
+    job->addr = client->addr;
+    job->flags = flags;
+    job->out_head = NULL;
+    job->out_tail = NULL;
+    job->out_bytes = 0;
+    job->size = size;
+    memcpy(job->data, data, size);
+    job->data[size] = '\0';
+    client->pending_jobs++;
+
+    // A connection always maps to the same worker, so its commands stay in order
+    NetWorker* worker = &workers->threads[(size_t)client->socket_fd % workers->count];
+    net_queue_push(&worker->queue, &job->node);
+    sem_post(&worker->ready);
+    return true;
+}
+
+#else
+
+struct NetWorkers* net_create_workers(size_t count) {
+    (void)count;
+    printf("Worker threads are not supported on this platform\n");
+    return NULL;
+}
+
+void net_destroy_workers(struct NetWorkers* workers) {
+    (void)workers;
+}
+
+size_t net_worker_count(const struct NetWorkers* workers) {
+    (void)workers;
+    return 0;
+}
+
+bool net_submit_job(NetworkProgram* program, ClientState* client,
+                    const void* data, size_t size, uint32_t flags) {
+    (void)program;
+    (void)client;
+    (void)data;
+    (void)size;
+    (void)flags;
+    return false;
+}
+
+bool net_init_wake(NetworkProgram* program) {
+    net_queue_init(&program->completions);
+    program->wake_fd = -1;
+    program->wake_signal_fd = -1;
+    return false;
+}
+
+void net_cleanup_wake(NetworkProgram* program) {
+    NetJob* job;
+    while ((job = net_next_completion(program))) {
+        net_free_job(job);
+    }
+}
+
+void net_clear_wake(NetworkProgram* program) {
+    (void)program;
+}
+#endif // _WIN32
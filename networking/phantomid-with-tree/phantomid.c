@@ -2,24 +2,70 @@
 #include "phantomid.h"
 #include "network.h"
 
-#define QUEUE_SIZE 1000
+#include <stdarg.h>
+#include <stddef.h>
+#include <limits.h>
+#include <sched.h>
 
-// Static globals
-static char error_buffer[256] = {0};
+#define QUEUE_INITIAL 64        // Initial traversal frontier (grows by doubling)
+#define SEED_BATCH 64           // Seeds drawn per RAND_bytes call when creating in bulk
 
-// Queue for BFS traversal
+// Static globals (errors are per thread once reactors run concurrently)
+static _Thread_local char error_buffer[256] = {0};
+
+// Growable text buffer for list responses
+typedef struct {
+    char* buffer;
+    size_t offset;
+    size_t max_size;
+} PrintContext;
+
+// Node deque for traversals (growable power-of-two ring): BFS pops the
+// front, DFS and cleanup pop the back, so no walk recurses on tree depth
 typedef struct {
-    PhantomNode* nodes[QUEUE_SIZE];
+    PhantomNode** nodes;
+    size_t capacity;
     size_t front;
-    size_t rear;
     size_t size;
 } NodeQueue;
 
+// Per-thread frontier arena, kept between traversals
+static pthread_key_t queue_key;
+static pthread_once_t queue_once = PTHREAD_ONCE_INIT;
+
 // Queue operations
 static void queue_init(NodeQueue* q) {
+    q->nodes = NULL;
+    q->capacity = 0;
+    q->front = 0;
+    q->size = 0;
+}
+
+static void queue_destroy(void* arg) {
+    NodeQueue* q = arg;
+    free(q->nodes);
+    free(q);
+}
+
+static void queue_key_init(void) {
+    pthread_key_create(&queue_key, queue_destroy);
+}
+
+// Empty frontier backed by this thread's arena (a thread runs one walk at a time)
+static NodeQueue* queue_acquire(void) {
+    pthread_once(&queue_once, queue_key_init);
+    
+    NodeQueue* q = pthread_getspecific(queue_key);
+    if (!q) {
+        q = malloc(sizeof(NodeQueue));
+        if (!q) return NULL;
+        queue_init(q);
+        pthread_setspecific(queue_key, q);
+    }
+    
     q->front = 0;
-    q->rear = 0;
     q->size = 0;
+    return q;
 }
 
 
@@ -28,10 +74,26 @@ void on_client_data(NetworkEndpoint* endpoint, NetworkPacket* packet);
 void on_client_connect(NetworkEndpoint* endpoint);
 void on_client_disconnect(NetworkEndpoint* endpoint);
 
+// Double the ring, unwrapping it so the oldest entry lands at index 0
+static bool queue_grow(NodeQueue* q) {
+    size_t capacity = q->capacity ? q->capacity * 2 : QUEUE_INITIAL;
+    PhantomNode** nodes = malloc(capacity * sizeof(PhantomNode*));
+    if (!nodes) return false;
+    
+    for (size_t i = 0; i < q->size; i++) {
+        nodes[i] = q->nodes[(q->front + i) & (q->capacity - 1)];
+    }
+    
+    free(q->nodes);
+    q->nodes = nodes;
+    q->capacity = capacity;
+    q->front = 0;
+    return true;
+}
+
 static bool queue_push(NodeQueue* q, PhantomNode* node) {
-    if (q->size >= QUEUE_SIZE) return false;
-    q->nodes[q->rear] = node;
-    q->rear = (q->rear + 1) % QUEUE_SIZE;
+    if (q->size == q->capacity && !queue_grow(q)) return false;
+    q->nodes[(q->front + q->size) & (q->capacity - 1)] = node;
     q->size++;
     return true;
 }
@@ -39,61 +101,497 @@ static bool queue_push(NodeQueue* q, PhantomNode* node) {
 static PhantomNode* queue_pop(NodeQueue* q) {
     if (q->size == 0) return NULL;
     PhantomNode* node = q->nodes[q->front];
-    q->front = (q->front + 1) % QUEUE_SIZE;
+    q->front = (q->front + 1) & (q->capacity - 1);
     q->size--;
     return node;
 }
 
-// Generate cryptographic seed
-static void generate_seed(uint8_t* seed) {
-    RAND_bytes(seed, 32);
+static PhantomNode* queue_pop_back(NodeQueue* q) {
+    if (q->size == 0) return NULL;
+    q->size--;
+    return q->nodes[(q->front + q->size) & (q->capacity - 1)];
+}
+
+// ID derivation in use (NULL is SHA-256 of the seed, through the fastest kernel)
+static _Atomic PhantomIdDerive id_derive = NULL;
+
+// Plug in another seed-to-ID derivation; NULL restores SHA-256
+void phantom_set_id_derive(PhantomIdDerive derive) {
+    atomic_store_explicit(&id_derive, derive, memory_order_relaxed);
+}
+
+// Derive count anonymous IDs from their seeds (stride bytes between
+// consecutive seeds and between consecutive IDs)
+void phantom_derive_ids(const uint8_t* seeds, uint8_t* ids, size_t count, size_t stride) {
+    PhantomIdDerive derive = atomic_load_explicit(&id_derive, memory_order_relaxed);
+    if (derive) {
+        derive(seeds, ids, count, stride);
+    } else {
+        sha256_seeds(seeds, ids, count, stride);
+    }
 }
 
-// Generate anonymous ID
-static void generate_id(const uint8_t* seed, char* id) {
-    unsigned int len;
-    uint8_t hash[EVP_MAX_MD_SIZE];
+// Generate count seed/ID pairs: one RAND_bytes call per SEED_BATCH seeds,
+// then every ID in one derivation call
+static bool generate_ids(IdPoolEntry* entries, size_t count) {
+    uint8_t seeds[SEED_BATCH][32];
+    
+    for (size_t i = 0; i < count; i += SEED_BATCH) {
+        size_t draw = count - i < SEED_BATCH ? count - i : SEED_BATCH;
+        if (RAND_bytes(&seeds[0][0], (int)(draw * 32)) != 1) {
+            snprintf(error_buffer, sizeof(error_buffer), "Failed to draw account seeds");
+            return false;
+        }
+        for (size_t j = 0; j < draw; j++) {
+            memcpy(entries[i + j].seed, seeds[j], 32);
+        }
+    }
     
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    if (ctx) {
-        EVP_DigestInit_ex(ctx, EVP_sha256(), NULL);
-        EVP_DigestUpdate(ctx, seed, 32);
-        EVP_DigestFinal_ex(ctx, hash, &len);
-        EVP_MD_CTX_free(ctx);
+    memset(seeds, 0, sizeof(seeds));
+    phantom_derive_ids(entries[0].seed, entries[0].id, count, sizeof(IdPoolEntry));
+    return true;
+}
+
+// ID pool refill (runs on the pool's thread)
+static bool fill_id_pool(IdPoolEntry* entries, size_t count, void* context) {
+    (void)context;
+    return generate_ids(entries, count);
+}
+
+// Fill count fresh accounts, sharing the clock: identities come from the ID
+// pool while it has them, the rest are generated here
+static bool init_accounts(PhantomDaemon* phantom, PhantomAccount* accounts, size_t count) {
+    IdPoolEntry entries[SEED_BATCH];
+    bool ok = true;
+    uint64_t now = (uint64_t)time(NULL);
+    memset(accounts, 0, count * sizeof(PhantomAccount));
+    
+    for (size_t i = 0; ok && i < count; i += SEED_BATCH) {
+        size_t chunk = count - i < SEED_BATCH ? count - i : SEED_BATCH;
+        size_t taken = idpool_take_many(phantom->ids, entries, chunk);
+        
+        if (taken < chunk) {
+            ok = generate_ids(entries + taken, chunk - taken);
+        }
         
-        for (unsigned int i = 0; i < 32; i++) {
-            sprintf(&id[i * 2], "%02x", hash[i]);
+        for (size_t j = 0; ok && j < chunk; j++) {
+            PhantomAccount* account = &accounts[i + j];
+            memcpy(account->seed, entries[j].seed, 32);
+            memcpy(account->id, entries[j].id, PHANTOM_ID_BYTES);
+            account->creation_time = now;
+            account->expiry_time = now + phantom->account_lifetime;
         }
-        id[64] = '\0';
     }
+    
+    memset(entries, 0, sizeof(entries));
+    return ok;
 }
 
-// Create new node
-static PhantomNode* create_node(const PhantomAccount* account, bool is_root) {
-    PhantomNode* node = calloc(1, sizeof(PhantomNode));
-    if (!node) {
-        snprintf(error_buffer, sizeof(error_buffer), "Failed to allocate node");
-        return NULL;
+// Fill a fresh account with seed, ID and lifetime
+static bool init_account(PhantomDaemon* phantom, PhantomAccount* account) {
+    return init_accounts(phantom, account, 1);
+}
+
+// Decode a hex ID from a text command: exactly 64 hex digits (the length is
+// checked first so the codec never reads past a short string)
+bool phantom_id_from_hex(const char* hex, uint8_t* id) {
+    if (!hex || !id) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
+        return false;
     }
     
-    node->children = calloc(MAX_CHILDREN, sizeof(PhantomNode*));
-    if (!node->children) {
-        snprintf(error_buffer, sizeof(error_buffer), "Failed to allocate children array");
-        free(node);
+    if (strnlen(hex, PHANTOM_ID_HEX) != PHANTOM_ID_BYTES * 2 ||
+        !hex_decode(hex, PHANTOM_ID_BYTES, id)) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid account ID");
+        return false;
+    }
+    return true;
+}
+
+// Encode a binary ID as 64 hex characters (hex holds PHANTOM_ID_HEX)
+void phantom_id_to_hex(const uint8_t* id, char* hex) {
+    hex_encode(id, PHANTOM_ID_BYTES, hex);
+    hex[PHANTOM_ID_BYTES * 2] = '\0';
+}
+
+// Create new node from the tree's pools
+static PhantomNode* create_node(PhantomTree* tree, const PhantomAccount* account, bool is_root) {
+    PhantomNode* node = slab_alloc(&tree->node_pool);
+    if (!node) {
+        snprintf(error_buffer, sizeof(error_buffer), "Failed to allocate node");
         return NULL;
     }
+    memset(node, 0, sizeof(PhantomNode));
     
     memcpy(&node->account, account, sizeof(PhantomAccount));
     node->parent = NULL;
+    node->children = node->inline_children;
     node->child_count = 0;
-    node->max_children = MAX_CHILDREN;
+    node->max_children = PHANTOM_INLINE_CHILDREN;
     node->is_root = is_root;
     node->is_admin = is_root;
     pthread_mutex_init(&node->node_lock, NULL);
+    expiry_timer_init(&node->expiry);
     
     return node;
 }
 
+// Pooled child array (the header lets a replaced array outlive its readers)
+typedef struct {
+    EpochEntry retire;
+    size_t capacity;
+    PhantomLink slots[];
+} ChildArray;
+
+// Size class for a child array of capacity slots (PHANTOM_CHILD_CLASSES means heap)
+static size_t child_class(size_t capacity) {
+    size_t size_class = 0;
+    while (size_class < PHANTOM_CHILD_CLASSES && ((size_t)PHANTOM_CHILD_CLASS_MIN << size_class) < capacity) {
+        size_class++;
+    }
+    return size_class;
+}
+
+static ChildArray* child_array_of(PhantomLink* slots) {
+    return (ChildArray*)((char*)slots - offsetof(ChildArray, slots));
+}
+
+static void child_array_free(PhantomTree* tree, ChildArray* array) {
+    size_t size_class = child_class(array->capacity);
+    if (size_class < PHANTOM_CHILD_CLASSES) {
+        slab_free(&tree->child_pools[size_class], array);
+    } else {
+        free(array);
+    }
+}
+
+// Epoch callback for a child array replaced by a larger one
+static void child_array_release(EpochEntry* entry, void* context) {
+    child_array_free(context, (ChildArray*)entry);
+}
+
+// Make room for capacity children, doubling the array (writer)
+static bool child_reserve(PhantomTree* tree, PhantomNode* node, size_t capacity) {
+    if (capacity <= node->max_children) return true;
+    
+    size_t grown = node->max_children * 2;
+    while (grown < capacity) grown *= 2;
+    
+    ChildArray* array;
+    size_t size_class = child_class(grown);
+    if (size_class < PHANTOM_CHILD_CLASSES) {
+        grown = (size_t)PHANTOM_CHILD_CLASS_MIN << size_class;
+        array = slab_alloc(&tree->child_pools[size_class]);
+    } else {
+        array = malloc(sizeof(ChildArray) + grown * sizeof(PhantomLink));
+    }
+    if (!array) {
+        snprintf(error_buffer, sizeof(error_buffer), "Failed to grow child list");
+        return false;
+    }
+    
+    PhantomLink* old = atomic_load_explicit(&node->children, memory_order_relaxed);
+    size_t count = atomic_load_explicit(&node->child_count, memory_order_relaxed);
+    array->capacity = grown;
+    for (size_t i = 0; i < count; i++) {
+        atomic_init(&array->slots[i], atomic_load_explicit(&old[i], memory_order_relaxed));
+    }
+    
+    // Readers still walking the old array keep it until they leave their epoch
+    atomic_store_explicit(&node->children, array->slots, memory_order_release);
+    node->max_children = grown;
+    if (old != node->inline_children) {
+        epoch_retire(&tree->epoch, &child_array_of(old)->retire, child_array_release, tree);
+    }
+    return true;
+}
+
+// Append a child (room reserved); the count is published after the slot
+static void child_append(PhantomNode* parent, PhantomNode* child) {
+    size_t count = atomic_load_explicit(&parent->child_count, memory_order_relaxed);
+    PhantomLink* slots = atomic_load_explicit(&parent->children, memory_order_relaxed);
+    
+    atomic_store_explicit(&child->parent, parent, memory_order_release);
+    child->child_slot = count;
+    atomic_store_explicit(&slots[count], child, memory_order_release);
+    atomic_store_explicit(&parent->child_count, count + 1, memory_order_release);
+}
+
+// Remove a child by moving the last child into its slot (writer)
+static void child_remove(PhantomNode* parent, PhantomNode* child) {
+    size_t count = atomic_load_explicit(&parent->child_count, memory_order_relaxed) - 1;
+    PhantomLink* slots = atomic_load_explicit(&parent->children, memory_order_relaxed);
+    
+    PhantomNode* last = atomic_load_explicit(&slots[count], memory_order_relaxed);
+    atomic_store_explicit(&slots[child->child_slot], last, memory_order_release);
+    last->child_slot = child->child_slot;
+    atomic_store_explicit(&parent->child_count, count, memory_order_release);
+}
+
+// Snapshot a node's children for a reader inside a read section
+static PhantomLink* child_snapshot(PhantomNode* node, size_t* count) {
+    *count = atomic_load_explicit(&node->child_count, memory_order_acquire);
+    return atomic_load_explicit(&node->children, memory_order_acquire);
+}
+
+// Return a node and its child array to the tree's pools
+static void destroy_node(PhantomTree* tree, PhantomNode* node) {
+    PhantomLink* slots = atomic_load_explicit(&node->children, memory_order_relaxed);
+    
+    pthread_mutex_destroy(&node->node_lock);
+    if (slots != node->inline_children) {
+        child_array_free(tree, child_array_of(slots));
+    }
+    slab_free(&tree->node_pool, node);
+}
+
+// Epoch callback for a deleted node
+static void node_release(EpochEntry* entry, void* context) {
+    destroy_node(context, (PhantomNode*)((char*)entry - offsetof(PhantomNode, retire)));
+}
+
+// Segment owning a hash (top bits pick the segment, low bits the bucket)
+static PhantomIndexSegment* index_segment(PhantomIndex* index, uint64_t hash) {
+    return &index->segments[(hash >> 58) % PHANTOM_INDEX_SEGMENTS];
+}
+
+// Zeroed bucket array
+static PhantomIndexTable* index_table_create(size_t bucket_count) {
+    PhantomIndexTable* table = calloc(1, sizeof(PhantomIndexTable) + bucket_count * sizeof(PhantomLink));
+    if (table) table->bucket_count = bucket_count;
+    return table;
+}
+
+static void index_table_release(EpochEntry* entry, void* context) {
+    (void)context;
+    free(entry);
+}
+
+static bool index_init(PhantomIndex* index, EpochDomain* epoch) {
+    index->epoch = epoch;
+    for (size_t i = 0; i < PHANTOM_INDEX_SEGMENTS; i++) {
+        PhantomIndexSegment* segment = &index->segments[i];
+        PhantomIndexTable* table = index_table_create(PHANTOM_INDEX_INITIAL);
+        if (!table) {
+            while (i-- > 0) {
+                pthread_mutex_destroy(&index->segments[i].lock);
+                free(atomic_load(&index->segments[i].table));
+            }
+            return false;
+        }
+        atomic_init(&segment->table, table);
+        atomic_init(&segment->sequence, 0);
+        segment->count = 0;
+        pthread_mutex_init(&segment->lock, NULL);
+    }
+    return true;
+}
+
+static void index_cleanup(PhantomIndex* index) {
+    for (size_t i = 0; i < PHANTOM_INDEX_SEGMENTS; i++) {
+        pthread_mutex_destroy(&index->segments[i].lock);
+        free(atomic_load(&index->segments[i].table));
+        atomic_store(&index->segments[i].table, NULL);
+    }
+}
+
+// Double a segment's bucket array (lock held); keeps the old one on failure.
+// Relinking moves nodes between chains, so the sequence is odd meanwhile and
+// lookups that miss during it retry.
+static void index_grow(PhantomIndex* index, PhantomIndexSegment* segment) {
+    PhantomIndexTable* old = atomic_load_explicit(&segment->table, memory_order_relaxed);
+    PhantomIndexTable* table = index_table_create(old->bucket_count * 2);
+    if (!table) return;
+    
+    unsigned sequence = atomic_load_explicit(&segment->sequence, memory_order_relaxed);
+    atomic_store_explicit(&segment->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    
+    for (size_t i = 0; i < old->bucket_count; i++) {
+        PhantomNode* node = atomic_load_explicit(&old->buckets[i], memory_order_relaxed);
+        while (node) {
+            PhantomNode* next = atomic_load_explicit(&node->index_next, memory_order_relaxed);
+            size_t bucket = node->index_hash & (table->bucket_count - 1);
+            atomic_store_explicit(&node->index_next,
+                                  atomic_load_explicit(&table->buckets[bucket], memory_order_relaxed),
+                                  memory_order_relaxed);
+            atomic_store_explicit(&table->buckets[bucket], node, memory_order_relaxed);
+            node = next;
+        }
+    }
+    
+    atomic_store_explicit(&segment->table, table, memory_order_release);
+    atomic_store_explicit(&segment->sequence, sequence + 2, memory_order_release);
+    epoch_retire(index->epoch, &old->retire, index_table_release, NULL);
+}
+
+// Add a node under its account ID; fails on a duplicate ID
+static bool index_insert(PhantomIndex* index, PhantomNode* node) {
+    node->index_hash = id_hash(node->account.id);
+    PhantomIndexSegment* segment = index_segment(index, node->index_hash);
+    
+    pthread_mutex_lock(&segment->lock);
+    
+    PhantomIndexTable* table = atomic_load_explicit(&segment->table, memory_order_relaxed);
+    PhantomLink* bucket = &table->buckets[node->index_hash & (table->bucket_count - 1)];
+    PhantomNode* head = atomic_load_explicit(bucket, memory_order_relaxed);
+    for (PhantomNode* entry = head; entry; entry = entry->index_next) {
+        if (entry->index_hash == node->index_hash &&
+            id_equal(entry->account.id, node->account.id)) {
+            pthread_mutex_unlock(&segment->lock);
+            return false;
+        }
+    }
+    
+    // Link fully, then publish at the bucket head
+    atomic_store_explicit(&node->index_next, head, memory_order_relaxed);
+    atomic_store_explicit(bucket, node, memory_order_release);
+    if (++segment->count > table->bucket_count) {
+        index_grow(index, segment);
+    }
+    
+    pthread_mutex_unlock(&segment->lock);
+    return true;
+}
+
+// Remove a node from the index (readers on it still find their way on)
+static void index_remove(PhantomIndex* index, PhantomNode* node) {
+    PhantomIndexSegment* segment = index_segment(index, node->index_hash);
+    
+    pthread_mutex_lock(&segment->lock);
+    
+    PhantomIndexTable* table = atomic_load_explicit(&segment->table, memory_order_relaxed);
+    PhantomLink* link = &table->buckets[node->index_hash & (table->bucket_count - 1)];
+    PhantomNode* entry;
+    while ((entry = atomic_load_explicit(link, memory_order_relaxed))) {
+        if (entry == node) {
+            atomic_store_explicit(link, atomic_load_explicit(&node->index_next, memory_order_relaxed),
+                                  memory_order_release);
+            segment->count--;
+            break;
+        }
+        link = &entry->index_next;
+    }
+    
+    pthread_mutex_unlock(&segment->lock);
+}
+
+// Look up a node by account ID without locking (caller is in a read section)
+static PhantomNode* index_lookup(PhantomIndex* index, const uint8_t* id) {
+    uint64_t hash = id_hash(id);
+    PhantomIndexSegment* segment = index_segment(index, hash);
+    
+    for (;;) {
+        unsigned sequence = atomic_load_explicit(&segment->sequence, memory_order_acquire);
+        PhantomIndexTable* table = atomic_load_explicit(&segment->table, memory_order_acquire);
+        
+        PhantomNode* entry = atomic_load_explicit(&table->buckets[hash & (table->bucket_count - 1)],
+                                                  memory_order_acquire);
+        for (; entry; entry = atomic_load_explicit(&entry->index_next, memory_order_acquire)) {
+            if (entry->index_hash == hash && id_equal(entry->account.id, id)) {
+                return entry;
+            }
+        }
+        
+        // A miss only counts if no grow moved entries underneath us
+        atomic_thread_fence(memory_order_acquire);
+        if (!(sequence & 1) &&
+            atomic_load_explicit(&segment->sequence, memory_order_relaxed) == sequence) {
+            return NULL;
+        }
+        sched_yield();
+    }
+}
+
+// Republish the earliest expiry time after the heap changed (tree_lock held)
+static void expiry_publish(PhantomTree* tree) {
+    atomic_store_explicit(&tree->expiry_due, expiry_next(&tree->expiry), memory_order_relaxed);
+}
+
+// Schedule a new node's removal; the caller reserved heap room, so this
+// cannot fail (tree_lock held). Accounts with no expiry time stay.
+static void expiry_add(PhantomTree* tree, PhantomNode* node) {
+    if (node->account.expiry_time == 0) return;
+    expiry_schedule(&tree->expiry, &node->expiry, node->account.expiry_time);
+}
+
+// Make room in the expiry heap for count more accounts (tree_lock held)
+static bool expiry_room(PhantomTree* tree, size_t count) {
+    if (expiry_reserve(&tree->expiry, expiry_count(&tree->expiry) + count)) return true;
+    snprintf(error_buffer, sizeof(error_buffer), "Failed to grow expiry schedule");
+    return false;
+}
+
+// Unindex and free a deleted subtree. Unindexing runs in bounded tree-lock
+// holds so writers interleave; once the last hold ends no writer can reach
+// the subtree, and every node is retired through the epoch.
+static void reap_subtree(PhantomTree* tree, PhantomNode* subtree) {
+    NodeQueue* stack = queue_acquire();
+    if (!stack || !queue_push(stack, subtree)) {
+        snprintf(error_buffer, sizeof(error_buffer), "Reaper stack allocation failed");
+        return;
+    }
+    
+    bool complete = true;
+    while (complete && stack->size > 0) {
+        pthread_mutex_lock(&tree->tree_lock);
+        for (size_t n = 0; complete && n < PHANTOM_REAP_BATCH && stack->size > 0; n++) {
+            PhantomNode* node = queue_pop_back(stack);
+            index_remove(&tree->index, node);
+            expiry_cancel(&tree->expiry, &node->expiry);
+            
+            size_t count;
+            PhantomLink* children = child_snapshot(node, &count);
+            for (size_t i = 0; i < count && complete; i++) {
+                complete = queue_push(stack, children[i]);
+            }
+        }
+        expiry_publish(tree);
+        pthread_mutex_unlock(&tree->tree_lock);
+    }
+    
+    // Out of memory part way: what is still indexed stays allocated
+    if (!complete || !queue_push(stack, subtree)) {
+        snprintf(error_buffer, sizeof(error_buffer), "Reaper stack allocation failed");
+        return;
+    }
+    
+    PhantomNode* node;
+    while ((node = queue_pop_back(stack)) != NULL) {
+        size_t count;
+        PhantomLink* children = child_snapshot(node, &count);
+        for (size_t i = 0; i < count; i++) {
+            queue_push(stack, children[i]);
+        }
+        
+        epoch_retire(&tree->epoch, &node->retire, node_release, tree);
+        atomic_fetch_sub(&tree->reap_pending, 1);
+    }
+}
+
+// Background reaper: frees deleted subtrees, draining the list before it exits
+static void* reaper_main(void* arg) {
+    PhantomTree* tree = arg;
+    
+    pthread_mutex_lock(&tree->reap_lock);
+    for (;;) {
+        while (!tree->reap_head && !tree->reaper_stop) {
+            pthread_cond_wait(&tree->reap_cond, &tree->reap_lock);
+        }
+        if (!tree->reap_head) break;
+        
+        PhantomNode* subtree = tree->reap_head;
+        tree->reap_head = subtree->reap_next;
+        pthread_mutex_unlock(&tree->reap_lock);
+        
+        reap_subtree(tree, subtree);
+        
+        pthread_mutex_lock(&tree->reap_lock);
+    }
+    pthread_mutex_unlock(&tree->reap_lock);
+    return NULL;
+}
+
 // Tree initialization
 bool phantom_tree_init(PhantomDaemon* phantom) {
     phantom->tree = calloc(1, sizeof(PhantomTree));
@@ -104,75 +602,141 @@ bool phantom_tree_init(PhantomDaemon* phantom) {
     
     phantom->tree->root = NULL;
     phantom->tree->total_nodes = 0;
+    phantom->tree->height = 0;
+    tour_init(&phantom->tree->tour);
+    expiry_init(&phantom->tree->expiry);
+    phantom->tree->expiry_due = EXPIRY_NEVER;
+    if (!epoch_init(&phantom->tree->epoch)) {
+        snprintf(error_buffer, sizeof(error_buffer), "Failed to create tree epochs");
+        free(phantom->tree);
+        phantom->tree = NULL;
+        return false;
+    }
+    
+    if (!index_init(&phantom->tree->index, &phantom->tree->epoch)) {
+        snprintf(error_buffer, sizeof(error_buffer), "Failed to allocate tree index");
+        epoch_destroy(&phantom->tree->epoch);
+        free(phantom->tree);
+        phantom->tree = NULL;
+        return false;
+    }
+    
+    bool pools = slab_init(&phantom->tree->node_pool, sizeof(PhantomNode));
+    for (size_t i = 0; i < PHANTOM_CHILD_CLASSES && pools; i++) {
+        pools = slab_init(&phantom->tree->child_pools[i],
+                          sizeof(ChildArray) + ((size_t)PHANTOM_CHILD_CLASS_MIN << i) * sizeof(PhantomLink));
+    }
+    if (!pools) {
+        snprintf(error_buffer, sizeof(error_buffer), "Failed to create node pools");
+        slab_destroy(&phantom->tree->node_pool);
+        for (size_t i = 0; i < PHANTOM_CHILD_CLASSES; i++) {
+            slab_destroy(&phantom->tree->child_pools[i]);
+        }
+        index_cleanup(&phantom->tree->index);
+        epoch_destroy(&phantom->tree->epoch);
+        free(phantom->tree);
+        phantom->tree = NULL;
+        return false;
+    }
     pthread_mutex_init(&phantom->tree->tree_lock, NULL);
+    
+    // Without the reaper, subtree deletes free inline
+    pthread_mutex_init(&phantom->tree->reap_lock, NULL);
+    pthread_cond_init(&phantom->tree->reap_cond, NULL);
+    phantom->tree->reaper_started =
+        pthread_create(&phantom->tree->reaper, NULL, reaper_main, phantom->tree) == 0;
     return true;
 }
 
-// Recursive cleanup helper
-static void cleanup_node(PhantomNode* node) {
-    if (!node) return;
-    
-    for (size_t i = 0; i < node->child_count; i++) {
-        cleanup_node(node->children[i]);
+// Free a subtree (no readers left); children are stacked before their parent goes
+static void cleanup_node(PhantomTree* tree, PhantomNode* node) {
+    NodeQueue* stack = queue_acquire();
+    if (!node || !stack || !queue_push(stack, node)) return;
+    
+    while ((node = queue_pop_back(stack)) != NULL) {
+        size_t count;
+        PhantomLink* children = child_snapshot(node, &count);
+        for (size_t i = 0; i < count; i++) {
+            if (!queue_push(stack, children[i])) {
+                // Out of memory: leave the rest to the slab teardown
+                snprintf(error_buffer, sizeof(error_buffer), "Cleanup stack allocation failed");
+                return;
+            }
+        }
+        
+        destroy_node(tree, node);
     }
-    
-    pthread_mutex_destroy(&node->node_lock);
-    free(node->children);
-    free(node);
 }
 
 // Tree cleanup
 void phantom_tree_cleanup(PhantomDaemon* phantom) {
     if (!phantom || !phantom->tree) return;
     
+    // Let the reaper finish deleted subtrees first
+    if (phantom->tree->reaper_started) {
+        pthread_mutex_lock(&phantom->tree->reap_lock);
+        phantom->tree->reaper_stop = true;
+        pthread_cond_signal(&phantom->tree->reap_cond);
+        pthread_mutex_unlock(&phantom->tree->reap_lock);
+        pthread_join(phantom->tree->reaper, NULL);
+    }
+    pthread_cond_destroy(&phantom->tree->reap_cond);
+    pthread_mutex_destroy(&phantom->tree->reap_lock);
+    
     pthread_mutex_lock(&phantom->tree->tree_lock);
-    cleanup_node(phantom->tree->root);
+    expiry_destroy(&phantom->tree->expiry);
+    cleanup_node(phantom->tree, phantom->tree->root);
     pthread_mutex_unlock(&phantom->tree->tree_lock);
     
+    // Deferred frees go back to the pools before the pools go away
+    epoch_destroy(&phantom->tree->epoch);
+    index_cleanup(&phantom->tree->index);
+    slab_destroy(&phantom->tree->node_pool);
+    for (size_t i = 0; i < PHANTOM_CHILD_CLASSES; i++) {
+        slab_destroy(&phantom->tree->child_pools[i]);
+    }
     pthread_mutex_destroy(&phantom->tree->tree_lock);
     free(phantom->tree);
     phantom->tree = NULL;
 }
 
-// Find node by ID
-PhantomNode* phantom_tree_find(PhantomDaemon* phantom, const char* id) {
+// Find node by ID (lock-free index lookup); using the node afterwards needs
+// a read section around the call
+PhantomNode* phantom_tree_find(PhantomDaemon* phantom, const uint8_t* id) {
     if (!phantom || !phantom->tree || !id) return NULL;
     
-    NodeQueue queue;
-    queue_init(&queue);
-    
-    pthread_mutex_lock(&phantom->tree->tree_lock);
-    
-    if (!phantom->tree->root) {
-        pthread_mutex_unlock(&phantom->tree->tree_lock);
-        return NULL;
-    }
-    
-    queue_push(&queue, phantom->tree->root);
-    
-    while (queue.size > 0) {
-        PhantomNode* node = queue_pop(&queue);
-        pthread_mutex_lock(&node->node_lock);
-        
-        if (strcmp(node->account.id, id) == 0) {
-            pthread_mutex_unlock(&node->node_lock);
-            pthread_mutex_unlock(&phantom->tree->tree_lock);
-            return node;
-        }
-        
-        for (size_t i = 0; i < node->child_count; i++) {
-            queue_push(&queue, node->children[i]);
-        }
-        
-        pthread_mutex_unlock(&node->node_lock);
-    }
-    
-    pthread_mutex_unlock(&phantom->tree->tree_lock);
-    return NULL;
+    phantom_read_begin(phantom);
+    PhantomNode* node = index_lookup(&phantom->tree->index, id);
+    phantom_read_end(phantom);
+    return node;
+}
+
+// Enter a read section; sections nest
+void phantom_read_begin(PhantomDaemon* phantom) {
+    epoch_enter(&phantom->tree->epoch);
+}
+
+void phantom_read_end(PhantomDaemon* phantom) {
+    epoch_exit(&phantom->tree->epoch);
+}
+
+// Look up a node still attached to the tree (tree_lock held); nodes of a
+// deleted subtree stay indexed until the reaper gets to them
+static PhantomNode* find_attached(PhantomDaemon* phantom, const uint8_t* id) {
+    PhantomNode* node = phantom_tree_find(phantom, id);
+    if (node && !tour_member(&phantom->tree->tour, &node->tour_enter)) return NULL;
+    return node;
+}
+
+// Whether node lies in ancestor's subtree, ancestor included (tree_lock held)
+static bool node_contains(PhantomNode* ancestor, PhantomNode* node) {
+    size_t position = tour_index(&node->tour_enter);
+    return tour_index(&ancestor->tour_enter) <= position &&
+           position < tour_index(&ancestor->tour_exit);
 }
 
 // Insert node into tree
-PhantomNode* phantom_tree_insert(PhantomDaemon* phantom, const PhantomAccount* account, const char* parent_id) {
+PhantomNode* phantom_tree_insert(PhantomDaemon* phantom, const PhantomAccount* account, const uint8_t* parent_id) {
     if (!phantom || !phantom->tree || !account) {
         snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
         return NULL;
@@ -188,17 +752,27 @@ PhantomNode* phantom_tree_insert(PhantomDaemon* phantom, const PhantomAccount* a
             return NULL;
         }
         
-        phantom->tree->root = create_node(account, true);
-        if (phantom->tree->root) {
+        PhantomNode* root = expiry_room(phantom->tree, 1) ? create_node(phantom->tree, account, true) : NULL;
+        if (root && !index_insert(&phantom->tree->index, root)) {
+            snprintf(error_buffer, sizeof(error_buffer), "Duplicate account ID");
+            destroy_node(phantom->tree, root);
+            root = NULL;
+        }
+        if (root) {
+            tour_insert(&phantom->tree->tour, NULL, &root->tour_enter, &root->tour_exit);
+            expiry_add(phantom->tree, root);
+            expiry_publish(phantom->tree);
+            phantom->tree->root = root;
             phantom->tree->total_nodes = 1;
+            phantom->tree->height = 1;
         }
         
         pthread_mutex_unlock(&phantom->tree->tree_lock);
-        return phantom->tree->root;
+        return root;
     }
     
     // Find parent node
-    PhantomNode* parent = parent_id ? phantom_tree_find(phantom, parent_id) : phantom->tree->root;
+    PhantomNode* parent = parent_id ? find_attached(phantom, parent_id) : phantom->tree->root;
     if (!parent) {
         pthread_mutex_unlock(&phantom->tree->tree_lock);
         snprintf(error_buffer, sizeof(error_buffer), "Parent node not found");
@@ -207,20 +781,27 @@ PhantomNode* phantom_tree_insert(PhantomDaemon* phantom, const PhantomAccount* a
     
     pthread_mutex_lock(&parent->node_lock);
     
-    // Check if parent can accept more children
-    if (parent->child_count >= parent->max_children) {
+    // Make room in the parent's child list and the expiry schedule
+    if (!child_reserve(phantom->tree, parent, parent->child_count + 1) || !expiry_room(phantom->tree, 1)) {
         pthread_mutex_unlock(&parent->node_lock);
         pthread_mutex_unlock(&phantom->tree->tree_lock);
-        snprintf(error_buffer, sizeof(error_buffer), "Parent node full");
         return NULL;
     }
     
     // Create and insert new node
-    PhantomNode* node = create_node(account, false);
+    PhantomNode* node = create_node(phantom->tree, account, false);
+    if (node && !index_insert(&phantom->tree->index, node)) {
+        snprintf(error_buffer, sizeof(error_buffer), "Duplicate account ID");
+        destroy_node(phantom->tree, node);
+        node = NULL;
+    }
     if (node) {
-        node->parent = parent;
-        parent->children[parent->child_count++] = node;
+        child_append(parent, node);
+        tour_insert(&phantom->tree->tour, &parent->tour_exit, &node->tour_enter, &node->tour_exit);
+        expiry_add(phantom->tree, node);
+        expiry_publish(phantom->tree);
         phantom->tree->total_nodes++;
+        phantom->tree->height = tour_height(&phantom->tree->tour);
     }
     
     pthread_mutex_unlock(&parent->node_lock);
@@ -229,136 +810,538 @@ PhantomNode* phantom_tree_insert(PhantomDaemon* phantom, const PhantomAccount* a
     return node;
 }
 
-// Delete node from tree
-bool phantom_tree_delete(PhantomDaemon* phantom, const char* id) {
-    if (!phantom || !phantom->tree || !id) return false;
+// Insert count accounts under one parent (the root when parent_id is NULL)
+// with one lock, one parent lookup and one child-list reservation. On an
+// empty tree the first account becomes the root, as with create, and the
+// rest go under it. All or nothing; nodes, if given, receives the new nodes
+// in order.
+bool phantom_tree_insert_batch(PhantomDaemon* phantom, const PhantomAccount* accounts, size_t count,
+                               const uint8_t* parent_id, PhantomNode** nodes) {
+    if (!phantom || !phantom->tree || !accounts || count == 0) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
+        return false;
+    }
     
-    pthread_mutex_lock(&phantom->tree->tree_lock);
+    PhantomNode** batch = nodes ? nodes : malloc(count * sizeof(PhantomNode*));
+    if (!batch) {
+        snprintf(error_buffer, sizeof(error_buffer), "Failed to allocate batch");
+        return false;
+    }
     
-    PhantomNode* node = phantom_tree_find(phantom, id);
-    if (!node) {
-        pthread_mutex_unlock(&phantom->tree->tree_lock);
+    PhantomTree* tree = phantom->tree;
+    pthread_mutex_lock(&tree->tree_lock);
+    
+    // Create root if tree is empty; it joins the tour only if the batch completes
+    PhantomNode* root = NULL;
+    if (!parent_id && !tree->root) {
+        root = expiry_room(tree, count) ? create_node(tree, &accounts[0], true) : NULL;
+        if (root && !index_insert(&tree->index, root)) {
+            snprintf(error_buffer, sizeof(error_buffer), "Duplicate account ID");
+            destroy_node(tree, root);
+            root = NULL;
+        }
+        if (!root) {
+            pthread_mutex_unlock(&tree->tree_lock);
+            if (batch != nodes) free(batch);
+            return false;
+        }
+        batch[0] = root;
+    }
+    size_t first = root ? 1 : 0;
+    
+    PhantomNode* parent = root ? root : parent_id ? find_attached(phantom, parent_id) : tree->root;
+    if (!parent) {
+        pthread_mutex_unlock(&tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Parent node not found");
+        if (batch != nodes) free(batch);
         return false;
     }
     
+    pthread_mutex_lock(&parent->node_lock);
+    
+    bool complete = child_reserve(tree, parent, parent->child_count + count - first) && expiry_room(tree, count);
+    size_t created = first;
+    for (; complete && created < count; created++) {
+        PhantomNode* node = create_node(tree, &accounts[created], false);
+        if (node && !index_insert(&tree->index, node)) {
+            snprintf(error_buffer, sizeof(error_buffer), "Duplicate account ID");
+            destroy_node(tree, node);
+            node = NULL;
+        }
+        if (!node) {
+            complete = false;
+            break;
+        }
+        batch[created] = node;
+    }
+    
+    if (complete) {
+        if (root) {
+            tour_insert(&tree->tour, NULL, &root->tour_enter, &root->tour_exit);
+            expiry_add(tree, root);
+            tree->root = root;
+            tree->total_nodes = 0;
+        }
+        for (size_t i = first; i < count; i++) {
+            child_append(parent, batch[i]);
+            tour_insert(&tree->tour, &parent->tour_exit, &batch[i]->tour_enter, &batch[i]->tour_exit);
+            expiry_add(tree, batch[i]);
+        }
+        expiry_publish(tree);
+        tree->total_nodes += count;
+        tree->height = tour_height(&tree->tour);
+    } else {
+        // Indexed nodes may already have been looked up; free them via the epoch
+        for (size_t i = 0; i < created; i++) {
+            index_remove(&tree->index, batch[i]);
+            epoch_retire(&tree->epoch, &batch[i]->retire, node_release, tree);
+        }
+    }
+    
+    pthread_mutex_unlock(&parent->node_lock);
+    pthread_mutex_unlock(&tree->tree_lock);
+    
+    if (batch != nodes) free(batch);
+    return complete;
+}
+
+// Delete one attached node; its parent adopts the children (tree_lock held)
+static bool delete_node(PhantomTree* tree, PhantomNode* node) {
     pthread_mutex_lock(&node->node_lock);
     
     // Cannot delete root if it has children
     if (node->is_root && node->child_count > 0) {
         pthread_mutex_unlock(&node->node_lock);
-        pthread_mutex_unlock(&phantom->tree->tree_lock);
         snprintf(error_buffer, sizeof(error_buffer), "Cannot delete root with children");
         return false;
     }
     
-    // Update parent's children array
-    if (node->parent) {
-        pthread_mutex_lock(&node->parent->node_lock);
-        
-        for (size_t i = 0; i < node->parent->child_count; i++) {
-            if (node->parent->children[i] == node) {
-                // Shift remaining children left
-                memmove(&node->parent->children[i],
-                       &node->parent->children[i + 1],
-                       (node->parent->child_count - i - 1) * sizeof(PhantomNode*));
-                node->parent->child_count--;
-                break;
-            }
+    // Parent adopts the children; grow its list before changing anything
+    PhantomNode* parent = node->parent;
+    if (parent) {
+        pthread_mutex_lock(&parent->node_lock);
+        if (!child_reserve(tree, parent, parent->child_count - 1 + node->child_count)) {
+            pthread_mutex_unlock(&parent->node_lock);
+            pthread_mutex_unlock(&node->node_lock);
+            return false;
         }
-        
-        pthread_mutex_unlock(&node->parent->node_lock);
+        child_remove(parent, node);
     } else {
-        phantom->tree->root = NULL;
+        tree->root = NULL;
     }
     
+    index_remove(&tree->index, node);
+    expiry_cancel(&tree->expiry, &node->expiry);
+    
     // Redistribute node's children
     for (size_t i = 0; i < node->child_count; i++) {
         PhantomNode* child = node->children[i];
         pthread_mutex_lock(&child->node_lock);
         
-        child->parent = node->parent;
         child->is_admin = node->is_admin; // Inherit admin status
-        
-        if (node->parent) {
-            pthread_mutex_lock(&node->parent->node_lock);
-            node->parent->children[node->parent->child_count++] = child;
-            pthread_mutex_unlock(&node->parent->node_lock);
+        if (parent) {
+            child_append(parent, child);
+        } else {
+            child->parent = NULL;
         }
         
         pthread_mutex_unlock(&child->node_lock);
     }
     
+    if (parent) {
+        pthread_mutex_unlock(&parent->node_lock);
+    }
+    
     pthread_mutex_unlock(&node->node_lock);
     
-    // Cleanup node
-    pthread_mutex_destroy(&node->node_lock);
-    free(node->children);
-    free(node);
+    // Descendants move up a level with the node's tour tokens gone
+    tour_remove(&tree->tour, &node->tour_enter, &node->tour_exit);
+    tree->height = tour_height(&tree->tour);
+    
+    // Free once readers that may still hold the node have moved on
+    epoch_retire(&tree->epoch, &node->retire, node_release, tree);
+    
+    tree->total_nodes--;
+    return true;
+}
+
+// Delete node from tree
+bool phantom_tree_delete(PhantomDaemon* phantom, const uint8_t* id) {
+    if (!phantom || !phantom->tree || !id) return false;
     
-    phantom->tree->total_nodes--;
+    pthread_mutex_lock(&phantom->tree->tree_lock);
+    
+    PhantomNode* node = find_attached(phantom, id);
+    if (!node) {
+        pthread_mutex_unlock(&phantom->tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Node not found");
+        return false;
+    }
+    
+    bool deleted = delete_node(phantom->tree, node);
+    if (deleted) expiry_publish(phantom->tree);
     
     pthread_mutex_unlock(&phantom->tree->tree_lock);
+    return deleted;
+}
+
+// Delete a node with its whole subtree. Unlinking is O(log N) under the
+// tree lock; the nodes are unindexed and freed by the background reaper.
+// removed, if given, receives the number of accounts deleted.
+bool phantom_tree_delete_subtree(PhantomDaemon* phantom, const uint8_t* id, size_t* removed) {
+    if (!phantom || !phantom->tree || !id) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
+        return false;
+    }
+    
+    PhantomTree* tree = phantom->tree;
+    pthread_mutex_lock(&tree->tree_lock);
+    
+    PhantomNode* node = find_attached(phantom, id);
+    if (!node) {
+        pthread_mutex_unlock(&tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Node not found");
+        return false;
+    }
+    
+    size_t size = tour_subtree_size(&node->tour_enter, &node->tour_exit);
+    
+    PhantomNode* parent = node->parent;
+    if (parent) {
+        pthread_mutex_lock(&parent->node_lock);
+        child_remove(parent, node);
+        pthread_mutex_unlock(&parent->node_lock);
+    } else {
+        tree->root = NULL;
+    }
+    
+    // The cut tokens stay with the subtree, so find_attached rejects its nodes
+    tour_cut(&tree->tour, &node->tour_enter, &node->tour_exit);
+    tree->total_nodes -= size;
+    tree->height = tour_height(&tree->tour);
+    atomic_fetch_add(&tree->reap_pending, size);
+    
+    pthread_mutex_unlock(&tree->tree_lock);
+    
+    if (tree->reaper_started) {
+        pthread_mutex_lock(&tree->reap_lock);
+        node->reap_next = tree->reap_head;
+        tree->reap_head = node;
+        pthread_cond_signal(&tree->reap_cond);
+        pthread_mutex_unlock(&tree->reap_lock);
+    } else {
+        reap_subtree(tree, node);
+    }
+    
+    if (removed) *removed = size;
     return true;
 }
 
+// Move a node with its subtree under a new parent; O(log N) under the tree lock
+bool phantom_tree_move(PhantomDaemon* phantom, const uint8_t* id, const uint8_t* parent_id) {
+    if (!phantom || !phantom->tree || !id || !parent_id) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
+        return false;
+    }
+    
+    PhantomTree* tree = phantom->tree;
+    pthread_mutex_lock(&tree->tree_lock);
+    
+    PhantomNode* node = find_attached(phantom, id);
+    PhantomNode* parent = find_attached(phantom, parent_id);
+    if (!node || !parent) {
+        pthread_mutex_unlock(&tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Node not found");
+        return false;
+    }
+    
+    PhantomNode* old_parent = node->parent;
+    if (!old_parent) {
+        pthread_mutex_unlock(&tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Cannot move the root");
+        return false;
+    }
+    if (node_contains(node, parent)) {
+        pthread_mutex_unlock(&tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Cannot move a node under its own subtree");
+        return false;
+    }
+    if (old_parent == parent) {
+        pthread_mutex_unlock(&tree->tree_lock);
+        return true;
+    }
+    
+    pthread_mutex_lock(&old_parent->node_lock);
+    pthread_mutex_lock(&parent->node_lock);
+    
+    bool reserved = child_reserve(tree, parent, parent->child_count + 1);
+    if (reserved) {
+        child_remove(old_parent, node);
+        child_append(parent, node);
+    }
+    
+    pthread_mutex_unlock(&parent->node_lock);
+    pthread_mutex_unlock(&old_parent->node_lock);
+    
+    if (reserved) {
+        TourToken* subtree = tour_cut(&tree->tour, &node->tour_enter, &node->tour_exit);
+        tour_paste(&tree->tour, &parent->tour_exit, subtree);
+        tree->height = tour_height(&tree->tour);
+    }
+    
+    pthread_mutex_unlock(&tree->tree_lock);
+    return reserved;
+}
+
+// Remove accounts whose expiry time is at or before now, at most limit in
+// one tree-lock hold. A root that still has children (or a delete that runs
+// out of memory) is retried PHANTOM_EXPIRY_RETRY seconds later. next_due, if
+// given, receives the earliest expiry time left. Returns accounts removed.
+size_t phantom_tree_expire(PhantomDaemon* phantom, uint64_t now, size_t limit, uint64_t* next_due) {
+    if (!phantom || !phantom->tree) return 0;
+    
+    PhantomTree* tree = phantom->tree;
+    size_t removed = 0;
+    
+    // Nothing due: don't touch the tree lock
+    if (atomic_load_explicit(&tree->expiry_due, memory_order_relaxed) <= now) {
+        pthread_mutex_lock(&tree->tree_lock);
+        
+        for (size_t n = 0; n < limit; n++) {
+            ExpiryTimer* timer = expiry_pop(&tree->expiry, now);
+            if (!timer) break;
+            
+            // Nodes of a deleted subtree are left to the reaper
+            PhantomNode* node = (PhantomNode*)((char*)timer - offsetof(PhantomNode, expiry));
+            if (!tour_member(&tree->tour, &node->tour_enter)) continue;
+            
+            if (delete_node(tree, node)) {
+                removed++;
+            } else {
+                expiry_schedule(&tree->expiry, &node->expiry, now + PHANTOM_EXPIRY_RETRY);
+                tree->expiry_deferred++;
+            }
+        }
+        expiry_publish(tree);
+        
+        // Per-second counts for the expiry rate
+        if (now != tree->expiry_second) {
+            tree->expired_last_second = now == tree->expiry_second + 1 ? tree->expired_this_second : 0;
+            tree->expiry_second = now;
+            tree->expired_this_second = 0;
+        }
+        tree->expired_this_second += removed;
+        tree->expired += removed;
+        if (tree->expired_this_second > tree->expired_peak) {
+            tree->expired_peak = tree->expired_this_second;
+        }
+        
+        pthread_mutex_unlock(&tree->tree_lock);
+    }
+    
+    if (next_due) *next_due = atomic_load_explicit(&tree->expiry_due, memory_order_relaxed);
+    return removed;
+}
+
 // BFS traversal
 void phantom_tree_bfs(PhantomDaemon* phantom, TreeVisitor visitor, void* user_data) {
     if (!phantom || !phantom->tree || !visitor) return;
     
-    NodeQueue queue;
-    queue_init(&queue);
+    NodeQueue* queue = queue_acquire();
+    if (!queue) {
+        snprintf(error_buffer, sizeof(error_buffer), "Failed to allocate traversal queue");
+        return;
+    }
     
-    pthread_mutex_lock(&phantom->tree->tree_lock);
+    phantom_read_begin(phantom);
     
-    if (!phantom->tree->root) {
-        pthread_mutex_unlock(&phantom->tree->tree_lock);
+    PhantomNode* root = atomic_load_explicit(&phantom->tree->root, memory_order_acquire);
+    bool complete = !root || queue_push(queue, root);
+    
+    while (complete && queue->size > 0) {
+        PhantomNode* node = queue_pop(queue);
+        visitor(node, user_data);
+        
+        size_t count;
+        PhantomLink* children = child_snapshot(node, &count);
+        for (size_t i = 0; i < count && complete; i++) {
+            complete = queue_push(queue, atomic_load_explicit(&children[i], memory_order_acquire));
+        }
+    }
+    
+    phantom_read_end(phantom);
+    
+    // Record why the traversal stopped early
+    if (!complete) {
+        snprintf(error_buffer, sizeof(error_buffer), "Traversal frontier allocation failed");
+    }
+}
+
+// DFS traversal (pre-order on an explicit stack; children pushed in reverse
+// so the first child is visited first)
+void phantom_tree_dfs(PhantomDaemon* phantom, TreeVisitor visitor, void* user_data) {
+    if (!phantom || !phantom->tree || !visitor) return;
+    
+    NodeQueue* stack = queue_acquire();
+    if (!stack) {
+        snprintf(error_buffer, sizeof(error_buffer), "Failed to allocate traversal stack");
         return;
     }
     
-    queue_push(&queue, phantom->tree->root);
+    phantom_read_begin(phantom);
     
-    while (queue.size > 0) {
-        PhantomNode* node = queue_pop(&queue);
-        pthread_mutex_lock(&node->node_lock);
-        
+    PhantomNode* root = atomic_load_explicit(&phantom->tree->root, memory_order_acquire);
+    bool complete = !root || queue_push(stack, root);
+    
+    while (complete && stack->size > 0) {
+        PhantomNode* node = queue_pop_back(stack);
         visitor(node, user_data);
         
-        for (size_t i = 0; i < node->child_count; i++) {
-            queue_push(&queue, node->children[i]);
+        size_t count;
+        PhantomLink* children = child_snapshot(node, &count);
+        for (size_t i = count; i > 0 && complete; i--) {
+            complete = queue_push(stack, atomic_load_explicit(&children[i - 1], memory_order_acquire));
         }
-        
-        pthread_mutex_unlock(&node->node_lock);
     }
     
-    pthread_mutex_unlock(&phantom->tree->tree_lock);
+    phantom_read_end(phantom);
+    
+    if (!complete) {
+        snprintf(error_buffer, sizeof(error_buffer), "Traversal stack allocation failed");
+    }
 }
 
-// DFS traversal helper
-static void dfs_helper(PhantomNode* node, TreeVisitor visitor, void* user_data) {
-    if (!node) return;
+// Snapshot walk entry: a live node and its parent's flat index
+typedef struct {
+    PhantomNode* node;
+    uint32_t parent;
+} SnapshotFrame;
+
+// Copy the tree into flat columns in pre-order (so index order is DFS order),
+// IDs as they are. One read section covers the walk; scans and exports then run
+// over the columns without touching live nodes.
+bool phantom_tree_snapshot(PhantomDaemon* phantom, FlatTree* flat) {
+    if (!phantom || !phantom->tree || !flat) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
+        return false;
+    }
     
-    pthread_mutex_lock(&node->node_lock);
+    flat_clear(flat);
     
-    visitor(node, user_data);
+    SnapshotFrame* stack = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+    bool complete = true;
     
-    for (size_t i = 0; i < node->child_count; i++) {
-        dfs_helper(node->children[i], visitor, user_data);
+    phantom_read_begin(phantom);
+    
+    PhantomNode* root = atomic_load_explicit(&phantom->tree->root, memory_order_acquire);
+    if (root) {
+        capacity = QUEUE_INITIAL;
+        stack = malloc(capacity * sizeof(SnapshotFrame));
+        complete = stack != NULL;
+        if (complete) stack[size++] = (SnapshotFrame){ root, FLAT_NONE };
     }
     
-    pthread_mutex_unlock(&node->node_lock);
+    while (complete && size > 0) {
+        SnapshotFrame frame = stack[--size];
+        PhantomNode* node = frame.node;
+        
+        uint8_t flags = (node->is_root ? PHANTOM_FLAG_ROOT : 0) |
+                        (node->is_admin ? PHANTOM_FLAG_ADMIN : 0);
+        uint32_t index = flat_append(flat, frame.parent, node->account.id, flags,
+                                     node->account.creation_time, node->account.expiry_time);
+        if (index == FLAT_NONE) {
+            complete = false;
+            break;
+        }
+        
+        size_t count;
+        PhantomLink* children = child_snapshot(node, &count);
+        if (size + count > capacity) {
+            while (size + count > capacity) capacity *= 2;
+            SnapshotFrame* grown = realloc(stack, capacity * sizeof(SnapshotFrame));
+            if (!grown) {
+                complete = false;
+                break;
+            }
+            stack = grown;
+        }
+        
+        // Reverse push keeps children in list order
+        for (size_t i = count; i > 0; i--) {
+            stack[size++] = (SnapshotFrame){
+                atomic_load_explicit(&children[i - 1], memory_order_acquire), index
+            };
+        }
+    }
+    
+    phantom_read_end(phantom);
+    free(stack);
+    
+    if (!complete) {
+        snprintf(error_buffer, sizeof(error_buffer), "Snapshot allocation failed");
+    }
+    return complete;
 }
 
-// DFS traversal
-void phantom_tree_dfs(PhantomDaemon* phantom, TreeVisitor visitor, void* user_data) {
-    if (!phantom || !phantom->tree || !visitor) return;
+// One parallel visit: the visitor and the per-thread context slots
+typedef struct {
+    TreeVisitor visitor;
+    char* contexts;
+    size_t context_size;
+} ParallelVisit;
+
+// Visit a node with this worker's context, then offer its children for stealing
+static void parallel_visit_task(StealWorker* worker, void* item, void* context) {
+    ParallelVisit* visit = context;
+    PhantomNode* node = item;
     
-    pthread_mutex_lock(&phantom->tree->tree_lock);
+    visit->visitor(node, visit->contexts + steal_worker_index(worker) * visit->context_size);
     
-    if (phantom->tree->root) {
-        dfs_helper(phantom->tree->root, visitor, user_data);
+    size_t count;
+    PhantomLink* children = child_snapshot(node, &count);
+    for (size_t i = count; i > 0; i--) {
+        steal_push(worker, atomic_load_explicit(&children[i - 1], memory_order_acquire));
+    }
+}
+
+// Context slots a parallel visit hands out (one per visiting thread)
+size_t phantom_tree_parallel_width(const PhantomDaemon* phantom) {
+    if (!phantom || !phantom->visitors) return 1;
+    return steal_thread_count(phantom->visitors);
+}
+
+// Visit every node once, in no particular order, on the work-stealing pool.
+// contexts holds phantom_tree_parallel_width() slots of context_size bytes;
+// the visitor gets the slot of the thread running it, so per-thread counts
+// need no atomics and the caller reduces the slots afterwards. Visitors run
+// concurrently and must not start another visit.
+bool phantom_tree_parallel_visit(PhantomDaemon* phantom, TreeVisitor visitor,
+                                 void* contexts, size_t context_size) {
+    if (!phantom || !phantom->tree || !visitor) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
+        return false;
     }
     
-    pthread_mutex_unlock(&phantom->tree->tree_lock);
+    if (!phantom->visitors) {
+        phantom_tree_dfs(phantom, visitor, contexts);
+        return true;
+    }
+    
+    ParallelVisit visit = {
+        .visitor = visitor,
+        .contexts = contexts,
+        .context_size = context_size
+    };
+    
+    // Helpers load nodes only after this section began, so it keeps
+    // everything they reach alive until the run returns
+    phantom_read_begin(phantom);
+    PhantomNode* root = atomic_load_explicit(&phantom->tree->root, memory_order_acquire);
+    steal_run(phantom->visitors, root, parallel_visit_task, &visit);
+    phantom_read_end(phantom);
+    return true;
 }
 
 // Tree status functions
@@ -372,34 +1355,249 @@ size_t phantom_tree_size(const PhantomDaemon* phantom) {
     return phantom->tree->total_nodes;
 }
 
-// Calculate tree depth helper
-static size_t get_depth_helper(PhantomNode* node) {
-    if (!node) return 0;
+// Tree depth in levels (kept current by every insert and delete)
+size_t phantom_tree_depth(const PhantomDaemon* phantom) {
+    if (!phantom || !phantom->tree) return 0;
+    return phantom->tree->height;
+}
+
+// Accounts in a node's subtree (itself included) and its depth (root is 0)
+bool phantom_tree_count(PhantomDaemon* phantom, const uint8_t* id, size_t* subtree, size_t* depth) {
+    if (!phantom || !phantom->tree || !id) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
+        return false;
+    }
     
-    size_t max_depth = 0;
-    for (size_t i = 0; i < node->child_count; i++) {
-        size_t depth = get_depth_helper(node->children[i]);
-        if (depth > max_depth) max_depth = depth;
+    pthread_mutex_lock(&phantom->tree->tree_lock);
+    
+    PhantomNode* node = find_attached(phantom, id);
+    if (!node) {
+        pthread_mutex_unlock(&phantom->tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Node not found");
+        return false;
     }
     
-    return max_depth + 1;
+    if (subtree) *subtree = tour_subtree_size(&node->tour_enter, &node->tour_exit);
+    if (depth) *depth = tour_depth(&node->tour_enter);
+    
+    pthread_mutex_unlock(&phantom->tree->tree_lock);
+    return true;
 }
 
-// Calculate tree depth
-size_t phantom_tree_depth(const PhantomDaemon* phantom) {
-    if (!phantom || !phantom->tree || !phantom->tree->root) return 0;
-    return get_depth_helper(phantom->tree->root);
+// Node owning an enter token
+static PhantomNode* node_of_enter(TourToken* enter) {
+    return (PhantomNode*)((char*)enter - offsetof(PhantomNode, tour_enter));
+}
+
+// Whether ancestor_id is id or one of its ancestors
+bool phantom_tree_is_ancestor(PhantomDaemon* phantom, const uint8_t* ancestor_id, const uint8_t* id, bool* result) {
+    if (!phantom || !phantom->tree || !ancestor_id || !id || !result) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
+        return false;
+    }
+    
+    pthread_mutex_lock(&phantom->tree->tree_lock);
+    
+    PhantomNode* ancestor = find_attached(phantom, ancestor_id);
+    PhantomNode* node = find_attached(phantom, id);
+    if (!ancestor || !node) {
+        pthread_mutex_unlock(&phantom->tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Node not found");
+        return false;
+    }
+    
+    *result = node_contains(ancestor, node);
+    
+    pthread_mutex_unlock(&phantom->tree->tree_lock);
+    return true;
+}
+
+// Ancestor k levels above a node (the node itself for k = 0)
+PhantomNode* phantom_tree_ancestor(PhantomDaemon* phantom, const uint8_t* id, size_t k) {
+    if (!phantom || !phantom->tree || !id) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
+        return NULL;
+    }
+    
+    pthread_mutex_lock(&phantom->tree->tree_lock);
+    
+    PhantomNode* node = find_attached(phantom, id);
+    if (!node) {
+        pthread_mutex_unlock(&phantom->tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Node not found");
+        return NULL;
+    }
+    
+    size_t depth = tour_depth(&node->tour_enter);
+    if (k > depth) {
+        pthread_mutex_unlock(&phantom->tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Ancestor beyond root");
+        return NULL;
+    }
+    
+    PhantomNode* ancestor = node_of_enter(tour_ancestor(&phantom->tree->tour, &node->tour_enter, depth - k));
+    
+    pthread_mutex_unlock(&phantom->tree->tree_lock);
+    return ancestor;
+}
+
+// Lowest common ancestor of two nodes
+PhantomNode* phantom_tree_lca(PhantomDaemon* phantom, const uint8_t* first_id, const uint8_t* second_id) {
+    if (!phantom || !phantom->tree || !first_id || !second_id) {
+        snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
+        return NULL;
+    }
+    
+    pthread_mutex_lock(&phantom->tree->tree_lock);
+    
+    PhantomNode* first = find_attached(phantom, first_id);
+    PhantomNode* second = find_attached(phantom, second_id);
+    if (!first || !second) {
+        pthread_mutex_unlock(&phantom->tree->tree_lock);
+        snprintf(error_buffer, sizeof(error_buffer), "Node not found");
+        return NULL;
+    }
+    
+    PhantomNode* lca = node_of_enter(tour_lca(&phantom->tree->tour, &first->tour_enter, &second->tour_enter));
+    
+    pthread_mutex_unlock(&phantom->tree->tree_lock);
+    return lca;
+}
+
+// Nodes of deleted subtrees the reaper has not freed yet
+size_t phantom_tree_reap_pending(const PhantomDaemon* phantom) {
+    if (!phantom || !phantom->tree) return 0;
+    return phantom->tree->reap_pending;
+}
+
+// Allocator statistics for the node and child-array pools
+bool phantom_alloc_stats(PhantomDaemon* phantom, SlabStats* nodes,
+                         SlabStats children[PHANTOM_CHILD_CLASSES]) {
+    if (!phantom || !phantom->tree) return false;
+    
+    if (nodes) slab_stats(&phantom->tree->node_pool, nodes);
+    for (size_t i = 0; children && i < PHANTOM_CHILD_CLASSES; i++) {
+        slab_stats(&phantom->tree->child_pools[i], &children[i]);
+    }
+    return true;
+}
+
+// ID pool statistics; false when creates generate their IDs on demand
+bool phantom_id_pool_stats(PhantomDaemon* phantom, IdPoolStats* stats) {
+    if (!phantom || !stats) return false;
+    
+    idpool_stats(phantom->ids, stats);
+    return phantom->ids != NULL;
+}
+
+// Expiry schedule statistics
+bool phantom_expiry_stats(PhantomDaemon* phantom, PhantomExpiryStats* stats) {
+    if (!phantom || !phantom->tree || !stats) return false;
+    
+    PhantomTree* tree = phantom->tree;
+    uint64_t now = (uint64_t)time(NULL);
+    
+    pthread_mutex_lock(&tree->tree_lock);
+    stats->scheduled = expiry_count(&tree->expiry);
+    stats->next_due = expiry_next(&tree->expiry);
+    stats->expired = tree->expired;
+    stats->deferred = tree->expiry_deferred;
+    stats->peak = tree->expired_peak;
+    if (now == tree->expiry_second) {
+        stats->last_second = tree->expired_last_second;
+    } else {
+        stats->last_second = now == tree->expiry_second + 1 ? tree->expired_this_second : 0;
+    }
+    pthread_mutex_unlock(&tree->tree_lock);
+    return true;
 }
 
 // Print tree helper
 static void print_node(PhantomNode* node, void* user_data) {
     int* level = (int*)user_data;
+    char id[PHANTOM_ID_HEX];
+    phantom_id_to_hex(node->account.id, id);
     for (int i = 0; i < *level; i++) printf("  ");
-    printf("- %s (%s, %s)\n", node->account.id,
+    printf("- %s (%s, %s)\n", id,
            node->is_root ? "Root" : "Child",
            node->is_admin ? "Admin" : "User");
 }
 
+// Append formatted text to a growable print context
+static bool print_append(PrintContext* ctx, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (length < 0) return false;
+    
+    size_t needed = ctx->offset + (size_t)length + 1;
+    if (needed > ctx->max_size) {
+        size_t size = ctx->max_size ? ctx->max_size : MAX_MESSAGE_SIZE;
+        while (size < needed) size *= 2;
+        
+        char* buffer = realloc(ctx->buffer, size);
+        if (!buffer) return false;
+        ctx->buffer = buffer;
+        ctx->max_size = size;
+    }
+    
+    va_start(args, format);
+    vsnprintf(ctx->buffer + ctx->offset, ctx->max_size - ctx->offset, format, args);
+    va_end(args);
+    ctx->offset += (size_t)length;
+    return true;
+}
+
+// Append raw bytes to a print context
+static bool print_bytes(PrintContext* ctx, const void* data, size_t size) {
+    size_t needed = ctx->offset + size;
+    if (needed > ctx->max_size) {
+        size_t capacity = ctx->max_size ? ctx->max_size : MAX_MESSAGE_SIZE;
+        while (capacity < needed) capacity *= 2;
+        
+        char* buffer = realloc(ctx->buffer, capacity);
+        if (!buffer) return false;
+        ctx->buffer = buffer;
+        ctx->max_size = capacity;
+    }
+    
+    memcpy(ctx->buffer + ctx->offset, data, size);
+    ctx->offset += size;
+    return true;
+}
+
+// Append a binary node record ([id:32][flags:1])
+static void print_node_record(PhantomNode* node, void* user_data) {
+    uint8_t record[PHANTOM_ID_BYTES + 1];
+    memcpy(record, node->account.id, PHANTOM_ID_BYTES);
+    record[PHANTOM_ID_BYTES] = (node->is_root ? PHANTOM_FLAG_ROOT : 0) |
+                               (node->is_admin ? PHANTOM_FLAG_ADMIN : 0);
+    print_bytes((PrintContext*)user_data, record, sizeof(record));
+}
+
+// Append a flat node as an export line
+static void print_flat_line(const FlatTree* flat, uint32_t index, void* user_data) {
+    char id[PHANTOM_ID_HEX];
+    phantom_id_to_hex(flat->id[index], id);
+    
+    if (flat->parent[index] == FLAT_NONE) {
+        print_append((PrintContext*)user_data, "%u - %u %s\n", index, flat->flags[index], id);
+    } else {
+        print_append((PrintContext*)user_data, "%u %u %u %s\n", index, flat->parent[index],
+                     flat->flags[index], id);
+    }
+}
+
+// Print node into a response listing
+static void print_node_to(PhantomNode* node, void* user_data) {
+    char id[PHANTOM_ID_HEX];
+    phantom_id_to_hex(node->account.id, id);
+    print_append((PrintContext*)user_data, "- %s (%s, %s)\n", id,
+                 node->is_root ? "Root" : "Child",
+                 node->is_admin ? "Admin" : "User");
+}
+
 // Print tree structure
 void phantom_tree_print(const PhantomDaemon* phantom) {
     if (!phantom || !phantom->tree) return;
@@ -409,12 +1607,45 @@ void phantom_tree_print(const PhantomDaemon* phantom) {
     phantom_tree_dfs((PhantomDaemon*)phantom, print_node, &level);
 }
 
-
-
+
+
+// Fill configuration with defaults
+void phantom_config_defaults(PhantomConfig* config) {
+    if (!config) return;
+    
+    memset(config, 0, sizeof(PhantomConfig));
+    config->port = 8888;
+    config->backend = NET_BACKEND_AUTO;
+    config->reactors = 1;
+#ifdef _WIN32
+    config->workers = 0;
+#else
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    config->workers = online > 0 ? (size_t)online : 1;
+#endif
+    config->max_clients = NET_MAX_CLIENTS;
+    config->output_high_water = NET_OUTPUT_HIGH_WATER;
+    config->pin_reactors = false;
+#ifdef _WIN32
+    config->visit_threads = 1;
+#else
+    config->visit_threads = online > 0 ? (size_t)online : 1;
+#endif
+    config->id_pool = IDPOOL_CAPACITY;
+    config->account_lifetime = PHANTOM_ACCOUNT_LIFETIME;
+    config->expiry_batch = PHANTOM_EXPIRY_BATCH;
+}
+
 // Initialize PhantomID daemon
-
 bool phantom_init(PhantomDaemon* phantom, uint16_t port) {
-    if (!phantom) return false;
+    PhantomConfig config;
+    phantom_config_defaults(&config);
+    config.port = port;
+    return phantom_init_config(phantom, &config);
+}
+
+bool phantom_init_config(PhantomDaemon* phantom, const PhantomConfig* config) {
+    if (!phantom || !config) return false;
     
     memset(phantom, 0, sizeof(PhantomDaemon));
     pthread_mutex_init(&phantom->state_lock, NULL);
@@ -423,36 +1654,90 @@ bool phantom_init(PhantomDaemon* phantom, uint16_t port) {
         return false;
     }
     
-    // Initialize network server
-    NetworkEndpoint server = {
-        .address = "0.0.0.0",
-        .port = port,
-        .protocol = NET_TCP,
-        .role = NET_SERVER,
-        .phantom = phantom
-    };
-    
-    phantom->network.endpoints = malloc(sizeof(NetworkEndpoint));
-    if (!phantom->network.endpoints) {
+    size_t count = config->reactors > 0 ? config->reactors : 1;
+    phantom->reactors = calloc(count, sizeof(NetworkProgram));
+    if (!phantom->reactors) {
         phantom_tree_cleanup(phantom);
         return false;
     }
+    phantom->pin_reactors = config->pin_reactors;
+    phantom->account_lifetime = config->account_lifetime;
+    phantom->expiry_batch = config->expiry_batch;
+    
+    // Commands run on the pool so slow ones don't stall a reactor
+    if (config->workers > 0) {
+        phantom->workers = net_create_workers(config->workers);
+        if (!phantom->workers) {
+            printf("Failed to start worker threads, running commands inline\n");
+        }
+    }
     
-    memcpy(phantom->network.endpoints, &server, sizeof(NetworkEndpoint));
-    phantom->network.count = 1;
-    phantom->network.phantom = phantom;
+    // Audits and sweeps split the tree across these threads
+    phantom->visitors = steal_create(config->visit_threads);
+    if (!phantom->visitors) {
+        printf("Failed to start tree visit threads, visiting on the caller only\n");
+    }
     
-    // Set up handlers
-    phantom->network.handlers.on_connect = phantom_on_client_connect;
-    phantom->network.handlers.on_disconnect = phantom_on_client_disconnect;
-    phantom->network.handlers.on_receive = phantom_on_client_data;
+    // Creates pop seed/ID pairs generated ahead on the pool's thread
+    if (config->id_pool > 0) {
+        phantom->ids = idpool_create(config->id_pool, config->id_pool / 4, fill_id_pool, NULL);
+        if (!phantom->ids) {
+            printf("Failed to start the ID pool, generating IDs on demand\n");
+        }
+    }
     
-    if (!net_init(&phantom->network.endpoints[0])) {
-        phantom_tree_cleanup(phantom);
-        free(phantom->network.endpoints);
-        return false;
+    // Each reactor owns a listener, client table and event loop
+    for (size_t i = 0; i < count; i++) {
+        NetworkProgram* network = &phantom->reactors[i];
+        
+        NetworkEndpoint server = {
+            .address = "0.0.0.0",
+            .port = config->port,
+            .protocol = NET_TCP,
+            .role = NET_SERVER,
+            .reuse_port = count > 1,
+            .phantom = phantom
+        };
+        
+        network->endpoints = malloc(sizeof(NetworkEndpoint));
+        if (!network->endpoints) {
+            phantom_cleanup(phantom);
+            return false;
+        }
+        
+        memcpy(network->endpoints, &server, sizeof(NetworkEndpoint));
+        network->phantom = phantom;
+        network->backend = config->backend;
+        network->max_clients = config->max_clients;
+        network->output_high_water = config->output_high_water;
+        network->workers = phantom->workers;
+        
+        // Set up handlers
+        network->handlers.on_connect = phantom_on_client_connect;
+        network->handlers.on_disconnect = phantom_on_client_disconnect;
+        network->handlers.on_receive = phantom_on_client_data;
+        
+        // Reactor 0 also expires accounts between waits
+        if (i == 0 && phantom->expiry_batch > 0) {
+            network->handlers.on_timer = phantom_on_timer;
+        }
+        
+        if (!net_init(&network->endpoints[0])) {
+            free(network->endpoints);
+            network->endpoints = NULL;
+            phantom_cleanup(phantom);
+            return false;
+        }
+        network->count = 1;
+        phantom->reactor_count = i + 1;
+        
+        net_init_program(network);
     }
     
+    printf("Using %zu %s reactor(s), %zu worker(s)\n", phantom->reactor_count,
+           net_backend_name(phantom->reactors[0].backend),
+           net_worker_count(phantom->reactors[0].workers));
+    
     return true;
 }
 
@@ -461,18 +1746,34 @@ void phantom_cleanup(PhantomDaemon* phantom) {
     if (!phantom) return;
     
     pthread_mutex_lock(&phantom->state_lock);
-    phantom->running = false;
+    atomic_store_explicit(&phantom->running, false, memory_order_relaxed);
+    
+    // Workers may still be running commands against the tree
+    net_destroy_workers(phantom->workers);
+    phantom->workers = NULL;
+    steal_destroy(phantom->visitors);
+    phantom->visitors = NULL;
+    idpool_destroy(phantom->ids);
+    phantom->ids = NULL;
     
     // Cleanup tree
     phantom_tree_cleanup(phantom);
     
     // Cleanup network resources
-    if (phantom->network.endpoints) {
-        for (size_t i = 0; i < phantom->network.count; i++) {
-            net_close(&phantom->network.endpoints[i]);
+    for (size_t r = 0; r < phantom->reactor_count; r++) {
+        NetworkProgram* network = &phantom->reactors[r];
+        
+        net_cleanup_program(network);
+        if (network->endpoints) {
+            for (size_t i = 0; i < network->count; i++) {
+                net_close(&network->endpoints[i]);
+            }
+            free(network->endpoints);
         }
-        free(phantom->network.endpoints);
     }
+    free(phantom->reactors);
+    phantom->reactors = NULL;
+    phantom->reactor_count = 0;
     
     pthread_mutex_unlock(&phantom->state_lock);
     pthread_mutex_destroy(&phantom->state_lock);
@@ -480,35 +1781,358 @@ void phantom_cleanup(PhantomDaemon* phantom) {
 
 
 
-// Network callbacks implementation
-void phantom_on_client_data(NetworkEndpoint* endpoint, NetworkPacket* packet) {
+// Send a binary response frame: opcode, status, payload
+static void send_binary_response(NetworkEndpoint* endpoint, uint8_t opcode, uint8_t status,
+                                 const void* payload, size_t size) {
+    PrintContext frame = {0};
+    uint8_t header[2] = { opcode, status };
+    
+    if (print_bytes(&frame, header, sizeof(header)) &&
+        (size == 0 || print_bytes(&frame, payload, size))) {
+        NetworkPacket resp = {
+            .data = frame.buffer,
+            .size = frame.offset,
+            .flags = 0
+        };
+        if (net_send_frame(endpoint, &resp) < 0) {
+            printf("Failed to send response to client\n");
+        }
+    }
+    free(frame.buffer);
+}
+
+// Send the current error text as a binary error response
+static void send_binary_error(NetworkEndpoint* endpoint, uint8_t opcode) {
+    const char* error = phantom_get_error();
+    send_binary_response(endpoint, opcode, PHANTOM_STATUS_ERROR, error, strlen(error));
+}
+
+// Store a 64-bit value big-endian
+static void put_be64(uint8_t* out, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        out[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+// Append a flat node as an export record
+static void print_flat_record(const FlatTree* flat, uint32_t index, void* user_data) {
+    uint8_t record[4 + 1 + PHANTOM_ID_BYTES + 16];
+    uint32_t parent = flat->parent[index];
+    
+    record[0] = (uint8_t)(parent >> 24);
+    record[1] = (uint8_t)(parent >> 16);
+    record[2] = (uint8_t)(parent >> 8);
+    record[3] = (uint8_t)parent;
+    record[4] = flat->flags[index];
+    memcpy(record + 5, flat->id[index], PHANTOM_ID_BYTES);
+    put_be64(record + 5 + PHANTOM_ID_BYTES, flat->created[index]);
+    put_be64(record + 13 + PHANTOM_ID_BYTES, flat->expires[index]);
+    print_bytes((PrintContext*)user_data, record, sizeof(record));
+}
+
+// Answer with a node's ID and flags
+static void send_binary_node(NetworkEndpoint* endpoint, uint8_t opcode, PhantomNode* node) {
+    uint8_t payload[PHANTOM_ID_BYTES + 1];
+    memcpy(payload, node->account.id, PHANTOM_ID_BYTES);
+    payload[PHANTOM_ID_BYTES] = (node->is_root ? PHANTOM_FLAG_ROOT : 0) |
+                                (node->is_admin ? PHANTOM_FLAG_ADMIN : 0);
+    send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, payload, sizeof(payload));
+}
+
+// Handle one binary protocol frame
+static void phantom_on_binary_frame(NetworkEndpoint* endpoint, NetworkPacket* packet) {
+    const uint8_t* body = packet->data;
+    if (packet->size == 0) {
+        send_binary_response(endpoint, 0, PHANTOM_STATUS_BAD_REQUEST, NULL, 0);
+        return;
+    }
+    
+    uint8_t opcode = body[0];
+    const uint8_t* operands = body + 1;
+    size_t length = packet->size - 1;
+    PhantomDaemon* phantom = endpoint->phantom;
+    
+    switch (opcode) {
+    case PHANTOM_OP_CREATE: {
+        if (length != 0 && length != PHANTOM_ID_BYTES) break;
+        
+        PhantomAccount account;
+        PhantomNode* node = init_account(phantom, &account)
+            ? phantom_tree_insert(phantom, &account, length ? operands : NULL) : NULL;
+        if (!node) {
+            send_binary_error(endpoint, opcode);
+            return;
+        }
+        
+        send_binary_node(endpoint, opcode, node);
+        return;
+    }
+    case PHANTOM_OP_CREATE_BATCH: {
+        if (length != 2 && length != 2 + PHANTOM_ID_BYTES) break;
+        size_t count = ((size_t)operands[0] << 8) | operands[1];
+        if (count == 0 || count > PHANTOM_BATCH_MAX) break;
+        
+        PhantomAccount* accounts = malloc(count * sizeof(PhantomAccount));
+        PhantomNode** nodes = malloc(count * sizeof(PhantomNode*));
+        uint8_t* payload = malloc(count * (PHANTOM_ID_BYTES + 1));
+        bool created = accounts && nodes && payload && init_accounts(phantom, accounts, count) &&
+                       phantom_tree_insert_batch(phantom, accounts, count,
+                                                 length > 2 ? operands + 2 : NULL, nodes);
+        
+        if (created) {
+            for (size_t i = 0; i < count; i++) {
+                uint8_t* record = payload + i * (PHANTOM_ID_BYTES + 1);
+                memcpy(record, accounts[i].id, PHANTOM_ID_BYTES);
+                record[PHANTOM_ID_BYTES] = (nodes[i]->is_root ? PHANTOM_FLAG_ROOT : 0) |
+                                           (nodes[i]->is_admin ? PHANTOM_FLAG_ADMIN : 0);
+            }
+            send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, payload,
+                                 count * (PHANTOM_ID_BYTES + 1));
+        } else {
+            if (!accounts || !nodes || !payload) {
+                snprintf(error_buffer, sizeof(error_buffer), "Failed to allocate batch");
+            }
+            send_binary_error(endpoint, opcode);
+        }
+        
+        free(payload);
+        free(nodes);
+        free(accounts);
+        return;
+    }
+    case PHANTOM_OP_DELETE:
+        if (length != PHANTOM_ID_BYTES) break;
+        
+        if (phantom_tree_delete(phantom, operands)) {
+            send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, NULL, 0);
+        } else {
+            send_binary_error(endpoint, opcode);
+        }
+        return;
+    case PHANTOM_OP_DELETE_SUBTREE: {
+        if (length != PHANTOM_ID_BYTES) break;
+        
+        size_t removed;
+        if (!phantom_tree_delete_subtree(phantom, operands, &removed)) {
+            send_binary_error(endpoint, opcode);
+            return;
+        }
+        
+        uint8_t payload[8];
+        put_be64(payload, removed);
+        send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, payload, sizeof(payload));
+        return;
+    }
+    case PHANTOM_OP_MOVE:
+        if (length != 2 * PHANTOM_ID_BYTES) break;
+        
+        if (phantom_tree_move(phantom, operands, operands + PHANTOM_ID_BYTES)) {
+            send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, NULL, 0);
+        } else {
+            send_binary_error(endpoint, opcode);
+        }
+        return;
+    case PHANTOM_OP_MSG: {
+        if (length < 2 * PHANTOM_ID_BYTES) break;
+        size_t content_length = length - 2 * PHANTOM_ID_BYTES;
+        if (content_length >= MAX_MESSAGE_SIZE) break;
+        
+        char content[MAX_MESSAGE_SIZE];
+        memcpy(content, operands + 2 * PHANTOM_ID_BYTES, content_length);
+        content[content_length] = '\0';
+        
+        if (phantom_message_send(phantom, operands, operands + PHANTOM_ID_BYTES, content)) {
+            send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, NULL, 0);
+        } else {
+            send_binary_error(endpoint, opcode);
+        }
+        return;
+    }
+    case PHANTOM_OP_STATS: {
+        uint8_t payload[17];
+        put_be64(payload, phantom_tree_size(phantom));
+        put_be64(payload + 8, phantom_tree_depth(phantom));
+        payload[16] = phantom_tree_has_root(phantom) ? 1 : 0;
+        send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, payload, sizeof(payload));
+        return;
+    }
+    case PHANTOM_OP_COUNT: {
+        if (length != PHANTOM_ID_BYTES) break;
+        
+        size_t subtree, depth;
+        if (!phantom_tree_count(phantom, operands, &subtree, &depth)) {
+            send_binary_error(endpoint, opcode);
+            return;
+        }
+        
+        uint8_t payload[16];
+        put_be64(payload, subtree);
+        put_be64(payload + 8, depth);
+        send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, payload, sizeof(payload));
+        return;
+    }
+    case PHANTOM_OP_IS_ANCESTOR: {
+        if (length != 2 * PHANTOM_ID_BYTES) break;
+        
+        bool result;
+        if (!phantom_tree_is_ancestor(phantom, operands, operands + PHANTOM_ID_BYTES, &result)) {
+            send_binary_error(endpoint, opcode);
+            return;
+        }
+        
+        uint8_t payload = result ? 1 : 0;
+        send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, &payload, 1);
+        return;
+    }
+    case PHANTOM_OP_ANCESTOR:
+    case PHANTOM_OP_LCA: {
+        if (length != PHANTOM_ID_BYTES + (opcode == PHANTOM_OP_LCA ? PHANTOM_ID_BYTES : 8)) break;
+        
+        PhantomNode* node;
+        phantom_read_begin(phantom);
+        if (opcode == PHANTOM_OP_LCA) {
+            node = phantom_tree_lca(phantom, operands, operands + PHANTOM_ID_BYTES);
+        } else {
+            uint64_t k = 0;
+            for (int i = 0; i < 8; i++) k = (k << 8) | operands[PHANTOM_ID_BYTES + i];
+            node = phantom_tree_ancestor(phantom, operands, (size_t)k);
+        }
+        
+        if (node) {
+            send_binary_node(endpoint, opcode, node);
+        } else {
+            send_binary_error(endpoint, opcode);
+        }
+        phantom_read_end(phantom);
+        return;
+    }
+    case PHANTOM_OP_EXPORT: {
+        FlatTree flat;
+        PrintContext records = {0};
+        uint8_t header[4];
+        
+        if (!flat_init(&flat, 0) || !phantom_tree_snapshot(phantom, &flat)) {
+            flat_destroy(&flat);
+            send_binary_error(endpoint, opcode);
+            return;
+        }
+        
+        header[0] = (uint8_t)(flat.count >> 24);
+        header[1] = (uint8_t)(flat.count >> 16);
+        header[2] = (uint8_t)(flat.count >> 8);
+        header[3] = (uint8_t)flat.count;
+        print_bytes(&records, header, sizeof(header));
+        flat_dfs(&flat, print_flat_record, &records);
+        flat_destroy(&flat);
+        
+        send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, records.buffer, records.offset);
+        free(records.buffer);
+        return;
+    }
+    case PHANTOM_OP_LIST_BFS:
+    case PHANTOM_OP_LIST_DFS: {
+        PrintContext records = {0};
+        if (opcode == PHANTOM_OP_LIST_BFS) {
+            phantom_tree_bfs(phantom, print_node_record, &records);
+        } else {
+            phantom_tree_dfs(phantom, print_node_record, &records);
+        }
+        send_binary_response(endpoint, opcode, PHANTOM_STATUS_OK, records.buffer, records.offset);
+        free(records.buffer);
+        return;
+    }
+    default:
+        send_binary_response(endpoint, opcode, PHANTOM_STATUS_UNKNOWN_OP, NULL, 0);
+        return;
+    }
+    
+    send_binary_response(endpoint, opcode, PHANTOM_STATUS_BAD_REQUEST, NULL, 0);
+}
+
+// Per-thread audit totals (a cache line each so threads don't share one)
+typedef struct {
+    _Alignas(64) size_t accounts;
+    size_t admins;
+    size_t expired;
+    uint64_t now;
+} AuditCounts;
+
+static void audit_node(PhantomNode* node, void* user_data) {
+    AuditCounts* counts = user_data;
+    counts->accounts++;
+    if (atomic_load_explicit(&node->is_admin, memory_order_relaxed)) counts->admins++;
+    if (node->account.expiry_time <= counts->now) counts->expired++;
+}
+
+// Handle one text command
+static void phantom_on_text_command(NetworkEndpoint* endpoint, NetworkPacket* packet) {
+    // Network layer delivers one NUL-terminated command per packet
     char* data = (char*)packet->data;
-    data[packet->size] = '\0';
     
-    printf("Received command: %s", data);
+    printf("Received command: %s\n", data);
     
     char response[MAX_MESSAGE_SIZE] = {0};
     NetworkPacket resp = {
         .data = response,
-        .size = sizeof(response),
+        .size = 0,
         .flags = 0
     };
+    PrintContext print_ctx = {0};
 
     // Parse command
-    if (strncmp(data, "create", 6) == 0) {
-        char parent_id[65] = {0};
-        if (sscanf(data + 6, "%64s", parent_id) == 1) {
-            PhantomAccount account = {0};
-            generate_seed(account.seed);
-            generate_id(account.seed, account.id);
-            account.creation_time = time(NULL);
-            account.expiry_time = account.creation_time + (90 * 24 * 60 * 60);
+    if (strncmp(data, "create-batch", 12) == 0) {
+        char parent_id[PHANTOM_ID_HEX] = {0};
+        uint8_t parent[PHANTOM_ID_BYTES];
+        size_t count = 0;
+        int fields = sscanf(data + 12, "%zu %64s", &count, parent_id);
+        
+        if (fields < 1 || count == 0 || count > PHANTOM_BATCH_MAX) {
+            snprintf(response, sizeof(response),
+                    "\nInvalid create-batch command. Use: create-batch <count 1-%d> [parent_id]\n",
+                    PHANTOM_BATCH_MAX);
+        } else if (fields == 2 && !phantom_id_from_hex(parent_id, parent)) {
+            snprintf(response, sizeof(response),
+                    "\nFailed to create accounts: %s\n", phantom_get_error());
+        } else {
+            PhantomAccount* accounts = malloc(count * sizeof(PhantomAccount));
+            if (accounts && init_accounts(endpoint->phantom, accounts, count) &&
+                phantom_tree_insert_batch(endpoint->phantom, accounts, count,
+                                          fields == 2 ? parent : NULL, NULL)) {
+                print_append(&print_ctx, "\nAccounts created: %zu\nParent: %s\n",
+                             count, fields == 2 ? parent_id : "root");
+                for (size_t i = 0; i < count; i++) {
+                    char id[PHANTOM_ID_HEX];
+                    phantom_id_to_hex(accounts[i].id, id);
+                    print_append(&print_ctx, "ID: %s\n", id);
+                }
+            }
             
-            PhantomNode* node = phantom_tree_insert(endpoint->phantom, &account, parent_id);
+            if (print_ctx.buffer) {
+                resp.data = print_ctx.buffer;
+                resp.size = print_ctx.offset;
+            } else {
+                snprintf(response, sizeof(response),
+                        "\nFailed to create accounts: %s\n",
+                        accounts ? phantom_get_error() : "Out of memory");
+            }
+            free(accounts);
+        }
+    }
+    else if (strncmp(data, "create", 6) == 0) {
+        char parent_id[PHANTOM_ID_HEX] = {0};
+        char id[PHANTOM_ID_HEX];
+        if (sscanf(data + 6, "%64s", parent_id) == 1) {
+            uint8_t parent[PHANTOM_ID_BYTES];
+            PhantomAccount account;
+            PhantomNode* node = phantom_id_from_hex(parent_id, parent) &&
+                                init_account(endpoint->phantom, &account)
+                ? phantom_tree_insert(endpoint->phantom, &account, parent) : NULL;
             if (node) {
+                phantom_id_to_hex(account.id, id);
                 snprintf(response, sizeof(response),
                         "\nAccount created:\nID: %s\nParent: %s\nRoot: %s\nAdmin: %s\n",
-                        account.id, parent_id,
+                        id, parent_id,
                         node->is_root ? "Yes" : "No",
                         node->is_admin ? "Yes" : "No");
             } else {
@@ -517,17 +2141,14 @@ void phantom_on_client_data(NetworkEndpoint* endpoint, NetworkPacket* packet) {
                         phantom_get_error());
             }
         } else {
-            PhantomAccount account = {0};
-            generate_seed(account.seed);
-            generate_id(account.seed, account.id);
-            account.creation_time = time(NULL);
-            account.expiry_time = account.creation_time + (90 * 24 * 60 * 60);
-            
-            PhantomNode* node = phantom_tree_insert(endpoint->phantom, &account, NULL);
+            PhantomAccount account;
+            PhantomNode* node = init_account(endpoint->phantom, &account)
+                ? phantom_tree_insert(endpoint->phantom, &account, NULL) : NULL;
             if (node) {
+                phantom_id_to_hex(account.id, id);
                 snprintf(response, sizeof(response),
                         "\nRoot account created:\nID: %s\n",
-                        account.id);
+                        id);
             } else {
                 snprintf(response, sizeof(response),
                         "\nFailed to create root account: %s\n",
@@ -535,10 +2156,42 @@ void phantom_on_client_data(NetworkEndpoint* endpoint, NetworkPacket* packet) {
             }
         }
     }
+    else if (strncmp(data, "delete-subtree", 14) == 0) {
+        char id[PHANTOM_ID_HEX] = {0};
+        uint8_t binary[PHANTOM_ID_BYTES];
+        size_t removed;
+        if (sscanf(data + 14, "%64s", id) != 1) {
+            snprintf(response, sizeof(response),
+                    "\nInvalid delete-subtree command. Use: delete-subtree <id>\n");
+        } else if (phantom_id_from_hex(id, binary) &&
+                   phantom_tree_delete_subtree(endpoint->phantom, binary, &removed)) {
+            snprintf(response, sizeof(response),
+                    "\nSubtree deleted: %s\nAccounts: %zu\n", id, removed);
+        } else {
+            snprintf(response, sizeof(response),
+                    "\nFailed to delete subtree: %s\n", phantom_get_error());
+        }
+    }
+    else if (strncmp(data, "move", 4) == 0) {
+        char id[PHANTOM_ID_HEX] = {0}, parent_id[PHANTOM_ID_HEX] = {0};
+        uint8_t binary[PHANTOM_ID_BYTES], parent[PHANTOM_ID_BYTES];
+        if (sscanf(data + 4, "%64s %64s", id, parent_id) != 2) {
+            snprintf(response, sizeof(response),
+                    "\nInvalid move command. Use: move <id> <parent_id>\n");
+        } else if (phantom_id_from_hex(id, binary) && phantom_id_from_hex(parent_id, parent) &&
+                   phantom_tree_move(endpoint->phantom, binary, parent)) {
+            snprintf(response, sizeof(response),
+                    "\nAccount moved: %s\nParent: %s\n", id, parent_id);
+        } else {
+            snprintf(response, sizeof(response),
+                    "\nFailed to move account: %s\n", phantom_get_error());
+        }
+    }
     else if (strncmp(data, "delete", 6) == 0) {
-        char id[65] = {0};
+        char id[PHANTOM_ID_HEX] = {0};
+        uint8_t binary[PHANTOM_ID_BYTES];
         if (sscanf(data + 6, "%64s", id) == 1) {
-            if (phantom_tree_delete(endpoint->phantom, id)) {
+            if (phantom_id_from_hex(id, binary) && phantom_tree_delete(endpoint->phantom, binary)) {
                 snprintf(response, sizeof(response),
                         "\nAccount deleted: %s\n", id);
             } else {
@@ -551,10 +2204,89 @@ void phantom_on_client_data(NetworkEndpoint* endpoint, NetworkPacket* packet) {
                     "\nInvalid delete command. Use: delete <id>\n");
         }
     }
+    else if (strncmp(data, "count", 5) == 0) {
+        char id[PHANTOM_ID_HEX] = {0};
+        uint8_t binary[PHANTOM_ID_BYTES];
+        size_t subtree, depth;
+        if (sscanf(data + 5, "%64s", id) != 1) {
+            snprintf(response, sizeof(response),
+                    "\nInvalid count command. Use: count <id>\n");
+        } else if (phantom_id_from_hex(id, binary) &&
+                   phantom_tree_count(endpoint->phantom, binary, &subtree, &depth)) {
+            snprintf(response, sizeof(response),
+                    "\nSubtree of %s:\nAccounts: %zu\nDepth: %zu\n", id, subtree, depth);
+        } else {
+            snprintf(response, sizeof(response),
+                    "\nFailed to count subtree: %s\n", phantom_get_error());
+        }
+    }
+    else if (strncmp(data, "isancestor", 10) == 0) {
+        char ancestor_id[PHANTOM_ID_HEX] = {0}, id[PHANTOM_ID_HEX] = {0};
+        uint8_t ancestor[PHANTOM_ID_BYTES], binary[PHANTOM_ID_BYTES];
+        bool result;
+        if (sscanf(data + 10, "%64s %64s", ancestor_id, id) != 2) {
+            snprintf(response, sizeof(response),
+                    "\nInvalid isancestor command. Use: isancestor <ancestor_id> <id>\n");
+        } else if (phantom_id_from_hex(ancestor_id, ancestor) && phantom_id_from_hex(id, binary) &&
+                   phantom_tree_is_ancestor(endpoint->phantom, ancestor, binary, &result)) {
+            snprintf(response, sizeof(response),
+                    "\n%s %s an ancestor of %s\n", ancestor_id, result ? "is" : "is not", id);
+        } else {
+            snprintf(response, sizeof(response),
+                    "\nFailed to check ancestor: %s\n", phantom_get_error());
+        }
+    }
+    else if (strncmp(data, "ancestor", 8) == 0) {
+        char id[PHANTOM_ID_HEX] = {0}, found[PHANTOM_ID_HEX];
+        uint8_t binary[PHANTOM_ID_BYTES];
+        size_t k;
+        if (sscanf(data + 8, "%64s %zu", id, &k) != 2) {
+            snprintf(response, sizeof(response),
+                    "\nInvalid ancestor command. Use: ancestor <id> <k>\n");
+        } else {
+            phantom_read_begin(endpoint->phantom);
+            PhantomNode* node = phantom_id_from_hex(id, binary)
+                ? phantom_tree_ancestor(endpoint->phantom, binary, k) : NULL;
+            if (node) phantom_id_to_hex(node->account.id, found);
+            phantom_read_end(endpoint->phantom);
+            
+            if (node) {
+                snprintf(response, sizeof(response),
+                        "\nAncestor %zu of %s:\nID: %s\n", k, id, found);
+            } else {
+                snprintf(response, sizeof(response),
+                        "\nFailed to find ancestor: %s\n", phantom_get_error());
+            }
+        }
+    }
+    else if (strncmp(data, "lca", 3) == 0) {
+        char first_id[PHANTOM_ID_HEX] = {0}, second_id[PHANTOM_ID_HEX] = {0}, found[PHANTOM_ID_HEX];
+        uint8_t first[PHANTOM_ID_BYTES], second[PHANTOM_ID_BYTES];
+        if (sscanf(data + 3, "%64s %64s", first_id, second_id) != 2) {
+            snprintf(response, sizeof(response),
+                    "\nInvalid lca command. Use: lca <id> <id>\n");
+        } else {
+            phantom_read_begin(endpoint->phantom);
+            PhantomNode* node = phantom_id_from_hex(first_id, first) && phantom_id_from_hex(second_id, second)
+                ? phantom_tree_lca(endpoint->phantom, first, second) : NULL;
+            if (node) phantom_id_to_hex(node->account.id, found);
+            phantom_read_end(endpoint->phantom);
+            
+            if (node) {
+                snprintf(response, sizeof(response),
+                        "\nCommon ancestor:\nID: %s\n", found);
+            } else {
+                snprintf(response, sizeof(response),
+                        "\nFailed to find common ancestor: %s\n", phantom_get_error());
+            }
+        }
+    }
     else if (strncmp(data, "msg", 3) == 0) {
-        char from_id[65] = {0}, to_id[65] = {0}, message[MAX_MESSAGE_SIZE] = {0};
-        if (sscanf(data, "msg %64s %64s <%[^>]>", from_id, to_id, message) == 3) {
-            if (phantom_message_send(endpoint->phantom, from_id, to_id, message)) {
+        char from_id[PHANTOM_ID_HEX] = {0}, to_id[PHANTOM_ID_HEX] = {0}, message[MAX_MESSAGE_SIZE] = {0};
+        uint8_t from[PHANTOM_ID_BYTES], to[PHANTOM_ID_BYTES];
+        if (sscanf(data, "msg %64s %64s <%4095[^>]>", from_id, to_id, message) == 3) {
+            if (phantom_id_from_hex(from_id, from) && phantom_id_from_hex(to_id, to) &&
+                phantom_message_send(endpoint->phantom, from, to, message)) {
                 snprintf(response, sizeof(response),
                         "\nMessage sent successfully from %s to %s\n", from_id, to_id);
             } else {
@@ -569,48 +2301,138 @@ void phantom_on_client_data(NetworkEndpoint* endpoint, NetworkPacket* packet) {
     }
     else if (strncmp(data, "list", 4) == 0) {
         if (strncmp(data + 4, " bfs", 4) == 0) {
-            snprintf(response, sizeof(response), "\nTree Structure (BFS):\n");
-            struct PrintContext {
-                char* buffer;
-                size_t offset;
-                size_t max_size;
-            } print_ctx = {response, strlen(response), sizeof(response)};
-            
-            phantom_tree_bfs(endpoint->phantom, print_node, &print_ctx);
-            resp.size = print_ctx.offset;
+            print_append(&print_ctx, "\nTree Structure (BFS):\n");
+            phantom_tree_bfs(endpoint->phantom, print_node_to, &print_ctx);
         }
         else if (strncmp(data + 4, " dfs", 4) == 0) {
-            snprintf(response, sizeof(response), "\nTree Structure (DFS):\n");
-            struct PrintContext {
-                char* buffer;
-                size_t offset;
-                size_t max_size;
-            } print_ctx = {response, strlen(response), sizeof(response)};
-            
-            phantom_tree_dfs(endpoint->phantom, print_node, &print_ctx);
-            resp.size = print_ctx.offset;
+            print_append(&print_ctx, "\nTree Structure (DFS):\n");
+            phantom_tree_dfs(endpoint->phantom, print_node_to, &print_ctx);
         }
         else {
             size_t total = phantom_tree_size(endpoint->phantom);
             size_t depth = phantom_tree_depth(endpoint->phantom);
             bool has_root = phantom_tree_has_root(endpoint->phantom);
             
-            snprintf(response, sizeof(response),
+            print_append(&print_ctx,
                     "\nTree Summary:\n"
                     "Total Nodes: %zu\n"
                     "Tree Depth: %zu\n"
                     "Root Node: %s\n\n",
                     total, depth,
                     has_root ? "Present" : "Not Present");
+            phantom_tree_dfs(endpoint->phantom, print_node_to, &print_ctx);
+        }
+        
+        // Listings can outgrow the fixed response buffer
+        if (print_ctx.buffer) {
+            resp.data = print_ctx.buffer;
+            resp.size = print_ctx.offset;
+        } else {
+            snprintf(response, sizeof(response), "\nFailed to build tree listing\n");
+        }
+    }
+    else if (strncmp(data, "export", 6) == 0) {
+        FlatTree flat;
+        if (flat_init(&flat, 0) && phantom_tree_snapshot(endpoint->phantom, &flat)) {
+            print_append(&print_ctx,
+                    "\nFlat export: %u accounts, %zu bytes (%zu per account, %zu live)\n"
+                    "index parent flags id\n",
+                    flat.count, (size_t)flat.count * flat_node_bytes(), flat_node_bytes(),
+                    sizeof(PhantomNode));
+            flat_dfs(&flat, print_flat_line, &print_ctx);
+        }
+        flat_destroy(&flat);
+        
+        if (print_ctx.buffer) {
+            resp.data = print_ctx.buffer;
+            resp.size = print_ctx.offset;
+        } else {
+            snprintf(response, sizeof(response), "\nFailed to export tree: %s\n", phantom_get_error());
+        }
+    }
+    else if (strncmp(data, "audit", 5) == 0) {
+        size_t width = phantom_tree_parallel_width(endpoint->phantom);
+        AuditCounts* counts = aligned_alloc(_Alignof(AuditCounts), width * sizeof(AuditCounts));
+        
+        if (!counts) {
+            snprintf(response, sizeof(response), "\nFailed to allocate audit counters\n");
+        } else {
+            uint64_t now = (uint64_t)time(NULL);
+            for (size_t i = 0; i < width; i++) {
+                counts[i] = (AuditCounts){ .now = now };
+            }
             
-            struct PrintContext {
-                char* buffer;
-                size_t offset;
-                size_t max_size;
-            } print_ctx = {response, strlen(response), sizeof(response)};
+            phantom_tree_parallel_visit(endpoint->phantom, audit_node, counts, sizeof(AuditCounts));
             
-            phantom_tree_print(endpoint->phantom);
-            resp.size = print_ctx.offset;
+            AuditCounts total = {0};
+            for (size_t i = 0; i < width; i++) {
+                total.accounts += counts[i].accounts;
+                total.admins += counts[i].admins;
+                total.expired += counts[i].expired;
+            }
+            free(counts);
+            
+            snprintf(response, sizeof(response),
+                    "\nAudit (%zu threads):\nAccounts: %zu\nAdmins: %zu\nExpired: %zu\n",
+                    width, total.accounts, total.admins, total.expired);
+        }
+    }
+    else if (strncmp(data, "alloc", 5) == 0) {
+        SlabStats pools[1 + PHANTOM_CHILD_CLASSES];
+        phantom_alloc_stats(endpoint->phantom, &pools[0], &pools[1]);
+        
+        int offset = 0;
+        offset += snprintf(response, sizeof(response), "\nAllocator statistics:\n");
+        for (int i = 0; i < 1 + PHANTOM_CHILD_CLASSES && offset < (int)sizeof(response); i++) {
+            if (i > 0 && pools[i].slabs == 0) continue;  // Child size_class never used
+            
+            char name[32];
+            if (i == 0) {
+                snprintf(name, sizeof(name), "Nodes");
+            } else {
+                snprintf(name, sizeof(name), "Child arrays x%d", PHANTOM_CHILD_CLASS_MIN << (i - 1));
+            }
+            offset += snprintf(response + offset, sizeof(response) - offset,
+                    "%s: %zu B objects, %zu in use, %zu cached, %zu capacity in %zu slabs\n"
+                    "  allocs %zu, frees %zu, refills %zu, flushes %zu\n",
+                    name, pools[i].object_size, pools[i].in_use, pools[i].cached,
+                    pools[i].capacity, pools[i].slabs, pools[i].allocs, pools[i].frees,
+                    pools[i].refills, pools[i].flushes);
+        }
+        if (offset < (int)sizeof(response)) {
+            snprintf(response + offset, sizeof(response) - offset,
+                    "Deleted nodes awaiting the reaper: %zu\n",
+                    phantom_tree_reap_pending(endpoint->phantom));
+        }
+    }
+    else if (strncmp(data, "expiry", 6) == 0) {
+        PhantomExpiryStats stats;
+        phantom_expiry_stats(endpoint->phantom, &stats);
+        
+        int offset = snprintf(response, sizeof(response),
+                "\nExpiry (%zu per tick, lifetime %llu s):\nScheduled: %zu\n",
+                endpoint->phantom->expiry_batch,
+                (unsigned long long)endpoint->phantom->account_lifetime, stats.scheduled);
+        if (stats.next_due != EXPIRY_NEVER) {
+            uint64_t now = (uint64_t)time(NULL);
+            offset += snprintf(response + offset, sizeof(response) - offset, "Next due: in %llu s\n",
+                    (unsigned long long)(stats.next_due > now ? stats.next_due - now : 0));
+        }
+        snprintf(response + offset, sizeof(response) - offset,
+                "Expired: %zu (last second %zu, peak %zu/s)\nDeferred: %zu\n",
+                stats.expired, stats.last_second, stats.peak, stats.deferred);
+    }
+    else if (strncmp(data, "idpool", 6) == 0) {
+        IdPoolStats stats;
+        if (phantom_id_pool_stats(endpoint->phantom, &stats)) {
+            snprintf(response, sizeof(response),
+                    "\nID pool:\nReady: %zu of %zu (refill below %zu)\n"
+                    "Taken: %zu, misses %zu\nGenerated: %zu in %zu batches, %.0f IDs/s\n",
+                    stats.ready, stats.capacity, stats.low_water, stats.taken, stats.misses,
+                    stats.generated, stats.batches, stats.refill_rate);
+        } else {
+            snprintf(response, sizeof(response),
+                    "\nID pool disabled: IDs are generated on demand\n");
         }
     }
     else if (strncmp(data, "help", 4) == 0) {
@@ -618,11 +2440,23 @@ void phantom_on_client_data(NetworkEndpoint* endpoint, NetworkPacket* packet) {
                 "\nPhantomID Commands:\n"
                 "----------------\n"
                 "create [parent_id]     Create new account (optionally under parent)\n"
+                "create-batch <n> [parent_id] Create n accounts under one parent (root by default)\n"
                 "delete <id>           Delete account\n"
+                "delete-subtree <id>   Delete account with all its descendants\n"
+                "move <id> <parent_id> Move account with its descendants under a new parent\n"
+                "count <id>            Show subtree size and depth of an account\n"
+                "isancestor <a> <id>   Check whether a is id or one of its ancestors\n"
+                "ancestor <id> <k>     Show the ancestor k levels above an account\n"
+                "lca <id> <id>         Show the lowest common ancestor of two accounts\n"
+                "audit                 Count accounts, admins and expired accounts in parallel\n"
+                "export                Dump the tree as flat rows (index, parent index, flags, id)\n"
                 "msg <from> <to> <msg> Send message between accounts\n"
                 "list                  Show tree summary and structure\n"
                 "list bfs              Show tree using breadth-first traversal\n"
                 "list dfs              Show tree using depth-first traversal\n"
+                "alloc                 Show node allocator statistics\n"
+                "idpool                Show pre-generated ID pool statistics\n"
+                "expiry                Show account expiry statistics\n"
                 "help                  Show this help message\n"
                 "quit                  Disconnect from server\n\n"
                 "Message format: msg <from_id> <to_id> <message in brackets>\n"
@@ -644,6 +2478,21 @@ void phantom_on_client_data(NetworkEndpoint* endpoint, NetworkPacket* packet) {
     if (net_send(endpoint, &resp) < 0) {
         printf("Failed to send response to client\n");
     }
+    free(print_ctx.buffer);
+}
+
+// Network callbacks implementation
+void phantom_on_client_data(NetworkEndpoint* endpoint, NetworkPacket* packet) {
+    // Nodes a command looks up or creates stay valid until it has answered
+    phantom_read_begin(endpoint->phantom);
+    
+    if (packet->flags & NET_PACKET_BINARY) {
+        phantom_on_binary_frame(endpoint, packet);
+    } else {
+        phantom_on_text_command(endpoint, packet);
+    }
+    
+    phantom_read_end(endpoint->phantom);
 }
 
 // Network callbacks with proper usage of parameters
@@ -668,36 +2517,102 @@ void phantom_on_client_disconnect(NetworkEndpoint* endpoint) {
     printf("Client disconnected from %s:%d\n", addr, 
            ntohs(endpoint->addr.sin_port));
 }
+// Reactor thread context
+typedef struct {
+    PhantomDaemon* phantom;
+    size_t index;
+} ReactorContext;
+
+// Reactor 0's timer: expire one batch of accounts, then wait no longer than
+// until the next one is due (not at all while a backlog remains)
+int phantom_on_timer(NetworkProgram* network) {
+    PhantomDaemon* phantom = network->phantom;
+    uint64_t now = (uint64_t)time(NULL);
+    uint64_t next_due;
+    
+    phantom_tree_expire(phantom, now, phantom->expiry_batch, &next_due);
+    if (next_due <= now) return 0;
+    if (next_due - now > INT_MAX / 1000) return -1;
+    return (int)((next_due - now) * 1000);
+}
+
+// Drive one reactor until the daemon stops
+static void* reactor_main(void* arg) {
+    ReactorContext* ctx = (ReactorContext*)arg;
+    PhantomDaemon* phantom = ctx->phantom;
+    NetworkProgram* network = &phantom->reactors[ctx->index];
+    
+    if (phantom->pin_reactors && !net_pin_thread(ctx->index)) {
+        printf("Failed to pin reactor %zu to CPU\n", ctx->index);
+    }
+    
+    network->running = true;  // Set network running flag
+    while (atomic_load_explicit(&phantom->running, memory_order_relaxed)) {
+        net_run(network);  // Blocks until activity or timeout
+    }
+    network->running = false;  // Clear network running flag
+    
+    return NULL;
+}
+
 // Run daemon
 void phantom_run(PhantomDaemon* phantom) {
-    if (!phantom) return;
+    if (!phantom || phantom->reactor_count == 0) return;
     
     printf("PhantomID daemon running...\n");
-    phantom->running = true;  // Set running flag
+    atomic_store_explicit(&phantom->running, true, memory_order_relaxed);  // Set running flag
 
-    NetworkProgram* network = &phantom->network;
-    network->running = true;  // Set network running flag
+    size_t count = phantom->reactor_count;
+    pthread_t* threads = calloc(count, sizeof(pthread_t));
+    ReactorContext* contexts = calloc(count, sizeof(ReactorContext));
+    if (!threads || !contexts) {
+        free(threads);
+        free(contexts);
+        count = 1;  // Degrade to a single reactor on this thread
+    }
+    
+    // Reactor 0 runs on the calling thread, the rest get their own
+    size_t started = 1;
+    for (size_t i = 1; i < count; i++) {
+        contexts[i] = (ReactorContext){ .phantom = phantom, .index = i };
+        if (pthread_create(&threads[i], NULL, reactor_main, &contexts[i]) != 0) {
+            printf("Failed to start reactor %zu\n", i);
+            break;
+        }
+        started++;
+    }
     
-    while (phantom->running) {
-        net_run(network);  // This should block until there's activity
-        if (!phantom->running) break;  // Check if we should stop
+    ReactorContext self = { .phantom = phantom, .index = 0 };
+    reactor_main(&self);
+    
+    for (size_t i = 1; i < started; i++) {
+        pthread_join(threads[i], NULL);
     }
+    free(threads);
+    free(contexts);
 
-    network->running = false;  // Clear network running flag
     printf("PhantomID daemon stopped\n");
 }
 
+// Ask all reactors to stop (async-signal-safe: a lock-free atomic store)
+void phantom_stop(PhantomDaemon* phantom) {
+    if (!phantom) return;
+    atomic_store_explicit(&phantom->running, false, memory_order_relaxed);
+}
+
 // Message sending implementation
-bool phantom_message_send(PhantomDaemon* phantom, const char* from_id,
-                         const char* to_id, const char* content) {
-    if (!phantom || !from_id || !to_id || !content) {
+bool phantom_message_send(PhantomDaemon* phantom, const uint8_t* from_id,
+                         const uint8_t* to_id, const char* content) {
+    if (!phantom || !phantom->tree || !from_id || !to_id || !content) {
         snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
         return false;
     }
     
-    // Verify both nodes exist
-    PhantomNode* from_node = phantom_tree_find(phantom, from_id);
-    PhantomNode* to_node = phantom_tree_find(phantom, to_id);
+    // Verify both nodes exist and were not deleted with a subtree
+    pthread_mutex_lock(&phantom->tree->tree_lock);
+    PhantomNode* from_node = find_attached(phantom, from_id);
+    PhantomNode* to_node = find_attached(phantom, to_id);
+    pthread_mutex_unlock(&phantom->tree->tree_lock);
     
     if (!from_node || !to_node) {
         snprintf(error_buffer, sizeof(error_buffer), "Source or destination node not found");
@@ -706,19 +2621,24 @@ bool phantom_message_send(PhantomDaemon* phantom, const char* from_id,
     
     // In a real implementation, I'd queue the message for delivery
     // For now, just log it
-    printf("Message from %s to %s: %s\n", from_id, to_id, content);
+    char from[PHANTOM_ID_HEX], to[PHANTOM_ID_HEX];
+    phantom_id_to_hex(from_id, from);
+    phantom_id_to_hex(to_id, to);
+    printf("Message from %s to %s: %s\n", from, to, content);
     return true;
 }
 
 // Get messages for a node
-PhantomMessage* phantom_message_get(PhantomDaemon* phantom, const char* id,
-                                  size_t* count) {    if (!phantom || !id || !count) {
+PhantomMessage* phantom_message_get(PhantomDaemon* phantom, const uint8_t* id,
+                                  size_t* count) {    if (!phantom || !phantom->tree || !id || !count) {
         snprintf(error_buffer, sizeof(error_buffer), "Invalid parameters");
         return NULL;
     }
     
-    // Verify node exists
-    PhantomNode* node = phantom_tree_find(phantom, id);
+    // Verify node exists and was not deleted with a subtree
+    pthread_mutex_lock(&phantom->tree->tree_lock);
+    PhantomNode* node = find_attached(phantom, id);
+    pthread_mutex_unlock(&phantom->tree->tree_lock);
     if (!node) {
         snprintf(error_buffer, sizeof(error_buffer), "Node not found");
         return NULL;
@@ -19,10 +19,61 @@
 #include <openssl/rand.h>
 #include <assert.h>
 #include "network.h"
+#include "slab.h"
+#include "epoch.h"
+#include "tour.h"
+#include "steal.h"
+#include "flat.h"
+#include "id.h"
+#include "hex.h"
+#include "idpool.h"
+#include "sha256.h"
+#include "expiry.h"
 
 #define MAX_ACCOUNTS 1000
 #define MAX_MESSAGE_SIZE 4096
-#define MAX_CHILDREN 10
+#define PHANTOM_INLINE_CHILDREN 2       // Child slots stored inside the node
+#define PHANTOM_CHILD_CLASS_MIN 4       // Slots in the smallest pooled child array
+#define PHANTOM_CHILD_CLASSES 8         // Pooled child-array sizes (4 << class slots)
+#define PHANTOM_ID_BYTES ID_BYTES
+#define PHANTOM_ID_HEX (PHANTOM_ID_BYTES * 2 + 1) // Hex ID with its terminator
+#define PHANTOM_INDEX_SEGMENTS 64       // Independently locked ID index segments
+#define PHANTOM_INDEX_INITIAL 16        // Initial buckets per index segment
+#define PHANTOM_ACCOUNT_LIFETIME (90 * 24 * 60 * 60)
+#define PHANTOM_BATCH_MAX 1024          // Accounts per create-batch request
+#define PHANTOM_REAP_BATCH 256          // Nodes unindexed per tree-lock hold by the reaper
+#define PHANTOM_EXPIRY_BATCH 256        // Accounts expired per event-loop tick
+#define PHANTOM_EXPIRY_RETRY 60         // Seconds before retrying an account that could not be removed
+
+// Binary protocol opcodes (request body: opcode byte, then operands)
+typedef enum {
+    PHANTOM_OP_CREATE = 0x01,       // [parent:32]?        -> [id:32][flags:1]
+    PHANTOM_OP_DELETE = 0x02,       // [id:32]             -> -
+    PHANTOM_OP_MSG = 0x03,          // [from:32][to:32][text] -> -
+    PHANTOM_OP_STATS = 0x04,        // -                   -> [nodes:8][depth:8][root:1]
+    PHANTOM_OP_LIST_BFS = 0x05,     // -                   -> ([id:32][flags:1])*
+    PHANTOM_OP_LIST_DFS = 0x06,     // -                   -> ([id:32][flags:1])*
+    PHANTOM_OP_COUNT = 0x07,        // [id:32]             -> [subtree:8][depth:8]
+    PHANTOM_OP_IS_ANCESTOR = 0x08,  // [ancestor:32][id:32] -> [result:1]
+    PHANTOM_OP_ANCESTOR = 0x09,     // [id:32][k:8]        -> [id:32][flags:1]
+    PHANTOM_OP_LCA = 0x0A,          // [id:32][id:32]      -> [id:32][flags:1]
+    PHANTOM_OP_CREATE_BATCH = 0x0B, // [count:2][parent:32]? -> ([id:32][flags:1])*
+    PHANTOM_OP_DELETE_SUBTREE = 0x0C, // [id:32]           -> [removed:8]
+    PHANTOM_OP_MOVE = 0x0D,         // [id:32][parent:32]  -> -
+    PHANTOM_OP_EXPORT = 0x0E        // -                   -> [count:4]([parent:4][flags:1][id:32][created:8][expiry:8])*
+} PhantomOpcode;
+
+// Binary protocol status (response body: opcode, status, payload)
+typedef enum {
+    PHANTOM_STATUS_OK = 0x00,           // Payload as listed above
+    PHANTOM_STATUS_ERROR = 0x01,        // Payload is the error text
+    PHANTOM_STATUS_BAD_REQUEST = 0x02,  // Malformed operands
+    PHANTOM_STATUS_UNKNOWN_OP = 0x03    // Unsupported opcode
+} PhantomStatus;
+
+// Node flags in binary responses
+#define PHANTOM_FLAG_ROOT 0x1
+#define PHANTOM_FLAG_ADMIN 0x2
 
 // Forward declarations
 struct PhantomNode;
@@ -36,7 +87,7 @@ typedef struct PhantomMessage PhantomMessage;
 // PhantomID account structure
 typedef struct {
     uint8_t seed[32];
-    char id[65];
+    uint8_t id[PHANTOM_ID_BYTES];       // SHA-256 of the seed (hex only on the wire)
     uint64_t creation_time;
     uint64_t expiry_time;
     pthread_mutex_t lock;
@@ -44,42 +95,128 @@ typedef struct {
 
 // Message structure
 struct PhantomMessage {
-    char from_id[65];
-    char to_id[65];
+    uint8_t from_id[PHANTOM_ID_BYTES];
+    uint8_t to_id[PHANTOM_ID_BYTES];
     char content[MAX_MESSAGE_SIZE];
     time_t timestamp;
 };
 
+// Node pointer that readers load without locks while writers update it
+typedef struct PhantomNode* _Atomic PhantomLink;
+
 // Tree node structure
 struct PhantomNode {
     PhantomAccount account;
-    struct PhantomNode* parent;
-    struct PhantomNode** children;
-    size_t child_count;
-    size_t max_children;
+    PhantomLink parent;
+    PhantomLink* _Atomic children;      // inline_children until it outgrows them
+    _Atomic size_t child_count;         // Published after the new child's slot
+    size_t max_children;                // Capacity of children
+    size_t child_slot;                  // Index in parent->children
     bool is_root;
-    bool is_admin;
+    atomic_bool is_admin;               // Inherited when the parent is deleted
     pthread_mutex_t node_lock;
+    uint64_t index_hash;                // Hash of account.id
+    PhantomLink index_next;             // Next node in the index bucket
+    EpochEntry retire;                  // Deferred free after delete
+    TourToken tour_enter;               // Euler tour tokens (tree_lock)
+    TourToken tour_exit;
+    PhantomNode* reap_next;             // Next deleted subtree awaiting the reaper
+    ExpiryTimer expiry;                 // Scheduled removal at account.expiry_time (tree_lock)
+    PhantomLink inline_children[PHANTOM_INLINE_CHILDREN];
 };
 
+// Bucket array of an index segment, replaced whole when the segment grows
+typedef struct {
+    EpochEntry retire;                  // Deferred free after a grow
+    size_t bucket_count;                // Power of two
+    PhantomLink buckets[];
+} PhantomIndexTable;
+
+// ID index segment (buckets chain through PhantomNode.index_next)
+typedef struct {
+    pthread_mutex_t lock;               // Serializes writers; readers take no lock
+    PhantomIndexTable* _Atomic table;   // Current bucket array
+    _Atomic unsigned sequence;          // Odd while a grow relinks the chains
+    size_t count;
+} PhantomIndexSegment;
+
+// Concurrent ID -> node index
+typedef struct {
+    PhantomIndexSegment segments[PHANTOM_INDEX_SEGMENTS];
+    EpochDomain* epoch;                 // Retires replaced bucket arrays
+} PhantomIndex;
+
 // Tree structure
 struct PhantomTree {
-    PhantomNode* root;
-    size_t total_nodes;
-    pthread_mutex_t tree_lock;
+    PhantomLink root;
+    _Atomic size_t total_nodes;
+    _Atomic size_t height;              // Levels, republished after every change
+    pthread_mutex_t tree_lock;          // Serializes writers; readers use epochs
+    Tour tour;                          // Subtree sizes and depths (tree_lock)
+    EpochDomain epoch;                  // Defers frees until readers move on
+    PhantomIndex index;                 // Account ID lookup
+    SlabPool node_pool;                 // PhantomNode storage
+    SlabPool child_pools[PHANTOM_CHILD_CLASSES]; // Child arrays by size class
+    pthread_t reaper;                   // Frees deleted subtrees in the background
+    bool reaper_started;
+    bool reaper_stop;                   // Drain the reap list and exit (reap_lock)
+    pthread_mutex_t reap_lock;          // Guards the reap list
+    pthread_cond_t reap_cond;           // Signals new work for the reaper
+    PhantomNode* reap_head;             // Deleted subtrees, linked through reap_next
+    _Atomic size_t reap_pending;        // Nodes deleted but not yet retired
+    ExpiryHeap expiry;                  // Account expiry times (tree_lock)
+    _Atomic uint64_t expiry_due;        // Earliest expiry time, republished after every change
+    size_t expired;                     // Accounts removed by expiry (tree_lock)
+    size_t expiry_deferred;             // Expiries put off (roots with children, no memory)
+    uint64_t expiry_second;             // Second the counts below belong to
+    size_t expired_this_second;
+    size_t expired_last_second;         // Removals in the last full second
+    size_t expired_peak;                // Most removals in any one second
 };
 
+// Expiry statistics snapshot
+typedef struct {
+    size_t scheduled;                   // Accounts waiting to expire
+    uint64_t next_due;                  // Earliest expiry time (EXPIRY_NEVER if none)
+    size_t expired;                     // Accounts removed by expiry
+    size_t deferred;                    // Expiries put off for a retry
+    size_t last_second;                 // Removals in the last full second
+    size_t peak;                        // Most removals in any one second
+} PhantomExpiryStats;
+
 // Network handlers declaration
 void phantom_on_client_data(NetworkEndpoint* endpoint, NetworkPacket* packet);
 void phantom_on_client_connect(NetworkEndpoint* endpoint);
 void phantom_on_client_disconnect(NetworkEndpoint* endpoint);
 
+// Daemon configuration
+typedef struct {
+    uint16_t port;              // Listening port
+    NetworkBackend backend;     // Event loop backend
+    size_t reactors;            // Reactor threads (SO_REUSEPORT shards)
+    size_t workers;             // Command worker threads (0 runs commands inline)
+    size_t max_clients;         // Client capacity per reactor
+    size_t output_high_water;   // Queued output per client that pauses reading
+    bool pin_reactors;          // Pin reactor i to CPU i
+    size_t visit_threads;       // Parallel tree visit threads, caller included
+    size_t id_pool;             // Seed/ID pairs generated ahead (0 generates on demand)
+    uint64_t account_lifetime;  // Seconds from creation to expiry
+    size_t expiry_batch;        // Accounts expired per event-loop tick (0 keeps them)
+} PhantomConfig;
+
 // PhantomID daemon state
 typedef struct PhantomDaemon {
-    NetworkProgram network;
+    NetworkProgram* reactors;       // One event loop per reactor thread
+    size_t reactor_count;
+    bool pin_reactors;
+    struct NetWorkers* workers;     // Command workers shared by all reactors
+    StealPool* visitors;            // Work-stealing pool for parallel tree visits
+    IdPool* ids;                    // Pre-generated seed/ID pairs (NULL when disabled)
+    uint64_t account_lifetime;      // Seconds from creation to expiry
+    size_t expiry_batch;            // Accounts expired per tick of reactor 0
     PhantomTree* tree;
     pthread_mutex_t state_lock;
-    bool running;
+    atomic_bool running;            // Cleared by phantom_stop, polled by every reactor
 } PhantomDaemon;
 
 // Tree traversal callback type
@@ -89,27 +226,66 @@ typedef void (*TreeVisitor)(PhantomNode* node, void* user_data);
 bool phantom_tree_init(PhantomDaemon* phantom);
 void phantom_tree_cleanup(PhantomDaemon* phantom);
 bool phantom_init(PhantomDaemon* phantom, uint16_t port);
+bool phantom_init_config(PhantomDaemon* phantom, const PhantomConfig* config);
+void phantom_config_defaults(PhantomConfig* config);
 void phantom_cleanup(PhantomDaemon* phantom);
 void phantom_run(PhantomDaemon* phantom);
+void phantom_stop(PhantomDaemon* phantom);
+
+// Tree operations (IDs are PHANTOM_ID_BYTES binary digests)
+PhantomNode* phantom_tree_insert(PhantomDaemon* phantom, const PhantomAccount* account, const uint8_t* parent_id);
+bool phantom_tree_insert_batch(PhantomDaemon* phantom, const PhantomAccount* accounts, size_t count,
+                               const uint8_t* parent_id, PhantomNode** nodes);
+bool phantom_tree_delete(PhantomDaemon* phantom, const uint8_t* id);
+bool phantom_tree_delete_subtree(PhantomDaemon* phantom, const uint8_t* id, size_t* removed);
+bool phantom_tree_move(PhantomDaemon* phantom, const uint8_t* id, const uint8_t* parent_id);
+PhantomNode* phantom_tree_find(PhantomDaemon* phantom, const uint8_t* id);
 
-// Tree operations
-PhantomNode* phantom_tree_insert(PhantomDaemon* phantom, const PhantomAccount* account, const char* parent_id);
-bool phantom_tree_delete(PhantomDaemon* phantom, const char* id);
-PhantomNode* phantom_tree_find(PhantomDaemon* phantom, const char* id);
+// Read sections (nodes from find/insert stay valid until the matching end)
+void phantom_read_begin(PhantomDaemon* phantom);
+void phantom_read_end(PhantomDaemon* phantom);
 
 // Tree traversal
 void phantom_tree_bfs(PhantomDaemon* phantom, TreeVisitor visitor, void* user_data);
 void phantom_tree_dfs(PhantomDaemon* phantom, TreeVisitor visitor, void* user_data);
+bool phantom_tree_snapshot(PhantomDaemon* phantom, FlatTree* flat);
+size_t phantom_tree_parallel_width(const PhantomDaemon* phantom);
+bool phantom_tree_parallel_visit(PhantomDaemon* phantom, TreeVisitor visitor,
+                                 void* contexts, size_t context_size);
 void phantom_tree_print(const PhantomDaemon* phantom);
 
 // Status queries
 bool phantom_tree_has_root(const PhantomDaemon* phantom);
 size_t phantom_tree_size(const PhantomDaemon* phantom);
 size_t phantom_tree_depth(const PhantomDaemon* phantom);
+bool phantom_tree_count(PhantomDaemon* phantom, const uint8_t* id, size_t* subtree, size_t* depth);
+
+// Ancestor queries (O(log N); returned nodes are valid inside a read section)
+bool phantom_tree_is_ancestor(PhantomDaemon* phantom, const uint8_t* ancestor_id, const uint8_t* id, bool* result);
+PhantomNode* phantom_tree_ancestor(PhantomDaemon* phantom, const uint8_t* id, size_t k);
+PhantomNode* phantom_tree_lca(PhantomDaemon* phantom, const uint8_t* first_id, const uint8_t* second_id);
+size_t phantom_tree_reap_pending(const PhantomDaemon* phantom);
+bool phantom_alloc_stats(PhantomDaemon* phantom, SlabStats* nodes,
+                         SlabStats children[PHANTOM_CHILD_CLASSES]);
+bool phantom_id_pool_stats(PhantomDaemon* phantom, IdPoolStats* stats);
+
+// Expiry (accounts are removed in batches once account.expiry_time passes)
+size_t phantom_tree_expire(PhantomDaemon* phantom, uint64_t now, size_t limit, uint64_t* next_due);
+bool phantom_expiry_stats(PhantomDaemon* phantom, PhantomExpiryStats* stats);
+int phantom_on_timer(NetworkProgram* network);
 
 // Message operations
-bool phantom_message_send(PhantomDaemon* phantom, const char* from_id, const char* to_id, const char* content);
-PhantomMessage* phantom_message_get(PhantomDaemon* phantom, const char* id, size_t* count);
+bool phantom_message_send(PhantomDaemon* phantom, const uint8_t* from_id, const uint8_t* to_id, const char* content);
+PhantomMessage* phantom_message_get(PhantomDaemon* phantom, const uint8_t* id, size_t* count);
+
+// ID encoding (text commands and logs; everything else stays binary)
+bool phantom_id_from_hex(const char* hex, uint8_t* id);
+void phantom_id_to_hex(const uint8_t* id, char* hex);
+
+// ID derivation (seed i at seeds + i * stride, its ID at ids + i * stride)
+typedef void (*PhantomIdDerive)(const uint8_t* seeds, uint8_t* ids, size_t count, size_t stride);
+void phantom_set_id_derive(PhantomIdDerive derive);
+void phantom_derive_ids(const uint8_t* seeds, uint8_t* ids, size_t count, size_t stride);
 
 // Utility functions
 const char* phantom_get_error(void);
@@ -0,0 +1,354 @@
+#include "sha256.h"
+
+#include <string.h>
+#include <stdatomic.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define SHA256_X86 1
+    #include <immintrin.h>
+#endif
+
+// One hashing implementation: hash digests exactly lanes messages
+typedef struct {
+    const char* name;
+    size_t lanes;
+    void (*hash)(const uint8_t* messages, uint8_t* digests, size_t stride);
+} Sha256Kernel;
+
+static const uint32_t sha256_initial[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static const uint32_t sha256_rounds[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+// A 32-byte message fills half the only block; the other half is always the
+// same padding: a one bit, zeros, and the length (256 bits)
+static const uint32_t sha256_padding[8] = { 0x80000000, 0, 0, 0, 0, 0, 0, 256 };
+
+static inline uint32_t sha256_load_be(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | bytes[3];
+}
+
+static inline void sha256_store_be(uint8_t* bytes, uint32_t word) {
+    bytes[0] = (uint8_t)(word >> 24);
+    bytes[1] = (uint8_t)(word >> 16);
+    bytes[2] = (uint8_t)(word >> 8);
+    bytes[3] = (uint8_t)word;
+}
+
+static inline uint32_t sha256_ror(uint32_t x, int n) {
+    return x >> n | x << (32 - n);
+}
+
+static void sha256_hash_scalar(const uint8_t* message, uint8_t* digest, size_t stride) {
+    (void)stride;
+    uint32_t w[64];
+    for (int i = 0; i < 8; i++) {
+        w[i] = sha256_load_be(message + i * 4);
+        w[i + 8] = sha256_padding[i];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = sha256_ror(w[i - 15], 7) ^ sha256_ror(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = sha256_ror(w[i - 2], 17) ^ sha256_ror(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = sha256_initial[0], b = sha256_initial[1], c = sha256_initial[2], d = sha256_initial[3];
+    uint32_t e = sha256_initial[4], f = sha256_initial[5], g = sha256_initial[6], h = sha256_initial[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (sha256_ror(e, 6) ^ sha256_ror(e, 11) ^ sha256_ror(e, 25)) +
+                      (g ^ (e & (f ^ g))) + sha256_rounds[i] + w[i];
+        uint32_t t2 = (sha256_ror(a, 2) ^ sha256_ror(a, 13) ^ sha256_ror(a, 22)) +
+                      ((a & b) | (c & (a | b)));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    const uint32_t state[8] = { a, b, c, d, e, f, g, h };
+    for (int i = 0; i < 8; i++) {
+        sha256_store_be(digest + i * 4, state[i] + sha256_initial[i]);
+    }
+}
+
+#ifdef SHA256_X86
+
+// SHA-NI: two rounds per sha256rnds2, the schedule four words at a time with
+// sha256msg1/msg2. State is kept as ABEF/CDGH as the instructions want it.
+__attribute__((target("sha,sse4.1")))
+static void sha256_hash_shani(const uint8_t* message, uint8_t* digest, size_t stride) {
+    (void)stride;
+    const __m128i swap = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+    __m128i state0 = _mm_loadu_si128((const __m128i*)&sha256_initial[0]);
+    __m128i state1 = _mm_loadu_si128((const __m128i*)&sha256_initial[4]);
+
+    state0 = _mm_shuffle_epi32(state0, 0xB1);              // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);              // EFGH
+    __m128i abef = _mm_alignr_epi8(state0, state1, 8);
+    __m128i cdgh = _mm_blend_epi16(state1, state0, 0xF0);
+    __m128i abef_start = abef;
+    __m128i cdgh_start = cdgh;
+
+    __m128i w[16];
+    w[0] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)message), swap);
+    w[1] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(message + 16)), swap);
+    w[2] = _mm_loadu_si128((const __m128i*)&sha256_padding[0]);
+    w[3] = _mm_loadu_si128((const __m128i*)&sha256_padding[4]);
+
+    for (int i = 0; i < 16; i++) {
+        if (i >= 4) {
+            __m128i next = _mm_sha256msg1_epu32(w[i - 4], w[i - 3]);
+            next = _mm_add_epi32(next, _mm_alignr_epi8(w[i - 1], w[i - 2], 4));
+            w[i] = _mm_sha256msg2_epu32(next, w[i - 1]);
+        }
+        __m128i words = _mm_add_epi32(w[i], _mm_loadu_si128((const __m128i*)&sha256_rounds[i * 4]));
+        cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words);
+        abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(words, 0x0E));
+    }
+
+    abef = _mm_add_epi32(abef, abef_start);
+    cdgh = _mm_add_epi32(cdgh, cdgh_start);
+    __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128((__m128i*)digest, _mm_shuffle_epi8(_mm_blend_epi16(feba, dchg, 0xF0), swap));
+    _mm_storeu_si128((__m128i*)(digest + 16), _mm_shuffle_epi8(_mm_alignr_epi8(dchg, feba, 8), swap));
+}
+
+// Multi-buffer kernels: one message per 32-bit lane, so each instruction
+// advances every lane's round. Message words are gathered across the lanes
+// and byte-swapped; the padding words are broadcast constants.
+#define SHA256_AVX2_ROR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define SHA256_AVX2_XOR3(a, b, c) _mm256_xor_si256(_mm256_xor_si256(a, b), c)
+
+__attribute__((target("avx2")))
+static void sha256_hash_avx2(const uint8_t* messages, uint8_t* digests, size_t stride) {
+    const __m256i swap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                          3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const int step = (int)stride;
+    const __m256i lanes = _mm256_setr_epi32(0, step, 2 * step, 3 * step, 4 * step, 5 * step, 6 * step, 7 * step);
+
+    __m256i w[16];
+    for (int i = 0; i < 8; i++) {
+        w[i] = _mm256_shuffle_epi8(_mm256_i32gather_epi32((const int*)(messages + i * 4), lanes, 1), swap);
+        w[i + 8] = _mm256_set1_epi32((int)sha256_padding[i]);
+    }
+
+    __m256i s[8];
+    for (int i = 0; i < 8; i++) s[i] = _mm256_set1_epi32((int)sha256_initial[i]);
+
+    for (int i = 0; i < 64; i++) {
+        if (i >= 16) {
+            __m256i x = w[(i - 15) & 15], y = w[(i - 2) & 15];
+            __m256i s0 = SHA256_AVX2_XOR3(SHA256_AVX2_ROR(x, 7), SHA256_AVX2_ROR(x, 18), _mm256_srli_epi32(x, 3));
+            __m256i s1 = SHA256_AVX2_XOR3(SHA256_AVX2_ROR(y, 17), SHA256_AVX2_ROR(y, 19), _mm256_srli_epi32(y, 10));
+            w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0), _mm256_add_epi32(w[(i - 7) & 15], s1));
+        }
+        __m256i e = s[4], a = s[0];
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, s[5]), _mm256_andnot_si256(e, s[6]));
+        __m256i maj = _mm256_or_si256(_mm256_and_si256(a, s[1]), _mm256_and_si256(s[2], _mm256_or_si256(a, s[1])));
+        __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(s[7], SHA256_AVX2_XOR3(SHA256_AVX2_ROR(e, 6), SHA256_AVX2_ROR(e, 11), SHA256_AVX2_ROR(e, 25))),
+                                      _mm256_add_epi32(_mm256_add_epi32(ch, w[i & 15]), _mm256_set1_epi32((int)sha256_rounds[i])));
+        __m256i t2 = _mm256_add_epi32(SHA256_AVX2_XOR3(SHA256_AVX2_ROR(a, 2), SHA256_AVX2_ROR(a, 13), SHA256_AVX2_ROR(a, 22)), maj);
+        s[7] = s[6];
+        s[6] = s[5];
+        s[5] = e;
+        s[4] = _mm256_add_epi32(s[3], t1);
+        s[3] = s[2];
+        s[2] = s[1];
+        s[1] = a;
+        s[0] = _mm256_add_epi32(t1, t2);
+    }
+
+    uint32_t words[8][8];
+    for (int i = 0; i < 8; i++) {
+        __m256i h = _mm256_add_epi32(s[i], _mm256_set1_epi32((int)sha256_initial[i]));
+        _mm256_storeu_si256((__m256i*)words[i], _mm256_shuffle_epi8(h, swap));
+    }
+    for (int lane = 0; lane < 8; lane++) {
+        for (int i = 0; i < 8; i++) {
+            memcpy(digests + lane * stride + i * 4, &words[i][lane], 4);
+        }
+    }
+}
+
+// AVX-512 has rotates and three-input logic (0x96 xor, 0xCA choose,
+// 0xE8 majority), so a round is about half the instructions of AVX2
+#define SHA256_AVX512_SIGMA(x, a, b, c) \
+    _mm512_ternarylogic_epi32(_mm512_ror_epi32(x, a), _mm512_ror_epi32(x, b), _mm512_ror_epi32(x, c), 0x96)
+#define SHA256_AVX512_SCHEDULE(x, a, b, c) \
+    _mm512_ternarylogic_epi32(_mm512_ror_epi32(x, a), _mm512_ror_epi32(x, b), _mm512_srli_epi32(x, c), 0x96)
+
+__attribute__((target("avx512f,avx512bw")))
+static void sha256_hash_avx512(const uint8_t* messages, uint8_t* digests, size_t stride) {
+    const __m512i swap = _mm512_broadcast_i32x4(_mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+    const __m512i lanes = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                             _mm512_set1_epi32((int)stride));
+
+    __m512i w[16];
+    for (int i = 0; i < 8; i++) {
+        w[i] = _mm512_shuffle_epi8(_mm512_i32gather_epi32(lanes, (const void*)(messages + i * 4), 1), swap);
+        w[i + 8] = _mm512_set1_epi32((int)sha256_padding[i]);
+    }
+
+    __m512i s[8];
+    for (int i = 0; i < 8; i++) s[i] = _mm512_set1_epi32((int)sha256_initial[i]);
+
+    for (int i = 0; i < 64; i++) {
+        if (i >= 16) {
+            __m512i s0 = SHA256_AVX512_SCHEDULE(w[(i - 15) & 15], 7, 18, 3);
+            __m512i s1 = SHA256_AVX512_SCHEDULE(w[(i - 2) & 15], 17, 19, 10);
+            w[i & 15] = _mm512_add_epi32(_mm512_add_epi32(w[i & 15], s0), _mm512_add_epi32(w[(i - 7) & 15], s1));
+        }
+        __m512i e = s[4], a = s[0];
+        __m512i t1 = _mm512_add_epi32(_mm512_add_epi32(s[7], SHA256_AVX512_SIGMA(e, 6, 11, 25)),
+                                      _mm512_add_epi32(_mm512_ternarylogic_epi32(e, s[5], s[6], 0xCA),
+                                                       _mm512_add_epi32(w[i & 15], _mm512_set1_epi32((int)sha256_rounds[i]))));
+        __m512i t2 = _mm512_add_epi32(SHA256_AVX512_SIGMA(a, 2, 13, 22),
+                                      _mm512_ternarylogic_epi32(a, s[1], s[2], 0xE8));
+        s[7] = s[6];
+        s[6] = s[5];
+        s[5] = e;
+        s[4] = _mm512_add_epi32(s[3], t1);
+        s[3] = s[2];
+        s[2] = s[1];
+        s[1] = a;
+        s[0] = _mm512_add_epi32(t1, t2);
+    }
+
+    uint32_t words[8][16];
+    for (int i = 0; i < 8; i++) {
+        __m512i h = _mm512_add_epi32(s[i], _mm512_set1_epi32((int)sha256_initial[i]));
+        _mm512_storeu_si512(words[i], _mm512_shuffle_epi8(h, swap));
+    }
+    for (int lane = 0; lane < 16; lane++) {
+        for (int i = 0; i < 8; i++) {
+            memcpy(digests + lane * stride + i * 4, &words[i][lane], 4);
+        }
+    }
+}
+
+#endif // SHA256_X86
+
+// Kernels, best first
+static const Sha256Kernel sha256_kernels[] = {
+#ifdef SHA256_X86
+    { "avx512", 16, sha256_hash_avx512 },
+    { "shani", 1, sha256_hash_shani },
+    { "avx2", 8, sha256_hash_avx2 },
+#endif
+    { "scalar", 1, sha256_hash_scalar }
+};
+
+#define SHA256_KERNEL_COUNT (sizeof(sha256_kernels) / sizeof(sha256_kernels[0]))
+
+// Selected kernel (threads racing on first use store the same one)
+static const Sha256Kernel* _Atomic sha256_active = NULL;
+
+static bool sha256_supported(const Sha256Kernel* kernel) {
+#ifdef SHA256_X86
+    __builtin_cpu_init();
+    if (kernel->hash == sha256_hash_avx512) {
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    }
+    if (kernel->hash == sha256_hash_shani) {
+        return __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+    }
+    if (kernel->hash == sha256_hash_avx2) return __builtin_cpu_supports("avx2");
+#endif
+    (void)kernel;
+    return true;
+}
+
+static const Sha256Kernel* sha256_select(void) {
+    const Sha256Kernel* kernel = atomic_load_explicit(&sha256_active, memory_order_relaxed);
+    if (kernel) return kernel;
+
+    kernel = &sha256_kernels[SHA256_KERNEL_COUNT - 1];
+    for (size_t i = 0; i < SHA256_KERNEL_COUNT; i++) {
+        if (sha256_supported(&sha256_kernels[i])) {
+            kernel = &sha256_kernels[i];
+            break;
+        }
+    }
+    atomic_store_explicit(&sha256_active, kernel, memory_order_relaxed);
+    return kernel;
+}
+
+// Best kernel that hashes one message per call
+static const Sha256Kernel* sha256_single(void) {
+    for (size_t i = 0; i < SHA256_KERNEL_COUNT; i++) {
+        if (sha256_kernels[i].lanes == 1 && sha256_supported(&sha256_kernels[i])) return &sha256_kernels[i];
+    }
+    return &sha256_kernels[SHA256_KERNEL_COUNT - 1];
+}
+
+// Hash count 32-byte messages (digests may share records with the messages
+// but must not overlap them)
+void sha256_seeds(const uint8_t* messages, uint8_t* digests, size_t count, size_t stride) {
+    const Sha256Kernel* kernel = sha256_select();
+    size_t i = 0;
+
+    for (; i + kernel->lanes <= count; i += kernel->lanes) {
+        kernel->hash(messages + i * stride, digests + i * stride, stride);
+    }
+    if (i == count) return;
+
+    // Short final group: SHA-NI hashes it one message at a time when the CPU
+    // has it (a padded group costs as much as a full one)
+    const Sha256Kernel* single = sha256_single();
+    if (single->hash != sha256_hash_scalar) {
+        for (; i < count; i++) single->hash(messages + i * stride, digests + i * stride, stride);
+        return;
+    }
+
+    // Otherwise fill the spare lanes with copies of the group's first message
+    uint8_t tail[SHA256_LANES_MAX][SHA256_SEED_BYTES];
+    uint8_t hashed[SHA256_LANES_MAX][SHA256_DIGEST_BYTES];
+    for (size_t lane = 0; lane < kernel->lanes; lane++) {
+        size_t index = i + lane < count ? i + lane : i;
+        memcpy(tail[lane], messages + index * stride, SHA256_SEED_BYTES);
+    }
+    kernel->hash(tail[0], hashed[0], SHA256_SEED_BYTES);
+    for (size_t lane = 0; i + lane < count; lane++) {
+        memcpy(digests + (i + lane) * stride, hashed[lane], SHA256_DIGEST_BYTES);
+    }
+    memset(tail, 0, sizeof(tail));
+}
+
+// Force a kernel by name ("avx512", "shani", "avx2", "scalar"; NULL for the
+// best the CPU runs); false if it is unknown or the CPU lacks it
+bool sha256_set_kernel(const char* name) {
+    if (!name) {
+        atomic_store_explicit(&sha256_active, NULL, memory_order_relaxed);
+        sha256_select();
+        return true;
+    }
+
+    for (size_t i = 0; i < SHA256_KERNEL_COUNT; i++) {
+        if (strcmp(sha256_kernels[i].name, name) == 0 && sha256_supported(&sha256_kernels[i])) {
+            atomic_store_explicit(&sha256_active, &sha256_kernels[i], memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Name of the kernel in use
+const char* sha256_kernel(void) {
+    return sha256_select()->name;
+}
@@ -0,0 +1,22 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// SHA-256 Constants
+#define SHA256_DIGEST_BYTES 32
+#define SHA256_SEED_BYTES 32        // The only message length hashed here (one padded block)
+#define SHA256_LANES_MAX 16         // Messages hashed together by the widest kernel
+
+// SHA-256 Functions. Digests count 32-byte messages; message i is read from
+// messages + i * stride and its digest written to digests + i * stride, so
+// seeds and IDs can sit side by side in one array of records. The kernel
+// (SHA-NI, AVX-512, AVX2 or scalar) is picked from the CPU on first use;
+// sha256_set_kernel forces one, NULL goes back to the best.
+void sha256_seeds(const uint8_t* messages, uint8_t* digests, size_t count, size_t stride);
+bool sha256_set_kernel(const char* name);
+const char* sha256_kernel(void);
+
+#endif // SHA256_H
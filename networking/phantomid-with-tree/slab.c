@@ -0,0 +1,254 @@
+#include "slab.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+// Per-thread object cache (owned by one thread, listed in its pool)
+struct SlabCache {
+    SlabPool* pool;                 // Owning pool
+    SlabCache* prev;                // Pool's cache list
+    SlabCache* next;
+    void* head;                     // Free objects (linked through their first word)
+    size_t count;                   // Free objects in this cache
+    _Atomic size_t allocs;          // Written by the owner, read by slab_stats
+    _Atomic size_t frees;
+};
+
+// Slab header, padded so objects stay aligned
+typedef union {
+    void* next;
+    char pad[SLAB_ALIGN];
+} SlabHeader;
+
+static inline void* object_next(void* object) {
+    return *(void**)object;
+}
+
+static inline void object_link(void* object, void* next) {
+    *(void**)object = next;
+}
+
+// Bump a counter only the owning thread writes (no locked RMW needed)
+static inline void counter_bump(_Atomic size_t* counter) {
+    atomic_store_explicit(counter,
+                          atomic_load_explicit(counter, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+}
+
+// Return a thread's cache to the pool when the thread exits
+static void slab_cache_retire(void* arg) {
+    SlabCache* cache = arg;
+    SlabPool* pool = cache->pool;
+
+    pthread_mutex_lock(&pool->lock);
+
+    while (cache->head) {
+        void* object = cache->head;
+        cache->head = object_next(object);
+        object_link(object, pool->free_list);
+        pool->free_list = object;
+        pool->free_count++;
+    }
+
+    pool->retired_allocs += atomic_load_explicit(&cache->allocs, memory_order_relaxed);
+    pool->retired_frees += atomic_load_explicit(&cache->frees, memory_order_relaxed);
+
+    if (cache->prev) cache->prev->next = cache->next;
+    else pool->caches = cache->next;
+    if (cache->next) cache->next->prev = cache->prev;
+
+    pthread_mutex_unlock(&pool->lock);
+    free(cache);
+}
+
+// This thread's cache, created on first use
+static SlabCache* slab_cache(SlabPool* pool) {
+    SlabCache* cache = pthread_getspecific(pool->key);
+    if (cache) return cache;
+
+    cache = calloc(1, sizeof(SlabCache));
+    if (!cache) return NULL;
+    cache->pool = pool;
+
+    if (pthread_setspecific(pool->key, cache) != 0) {
+        free(cache);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    cache->next = pool->caches;
+    if (pool->caches) pool->caches->prev = cache;
+    pool->caches = cache;
+    pthread_mutex_unlock(&pool->lock);
+    return cache;
+}
+
+// Carve a new slab onto the shared free list (lock held)
+static bool slab_carve(SlabPool* pool) {
+    SlabHeader* slab = malloc(sizeof(SlabHeader) + pool->slab_objects * pool->object_size);
+    if (!slab) return false;
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->slab_count++;
+
+    // Link back to front so objects are handed out in address order
+    char* objects = (char*)(slab + 1);
+    for (size_t i = pool->slab_objects; i-- > 0; ) {
+        void* object = objects + i * pool->object_size;
+        object_link(object, pool->free_list);
+        pool->free_list = object;
+    }
+    pool->free_count += pool->slab_objects;
+    return true;
+}
+
+// Move a batch of shared free objects into the cache
+static bool slab_refill(SlabPool* pool, SlabCache* cache) {
+    pthread_mutex_lock(&pool->lock);
+
+    if (pool->free_count < SLAB_BATCH && !slab_carve(pool) && pool->free_count == 0) {
+        pthread_mutex_unlock(&pool->lock);
+        return false;
+    }
+
+    for (size_t i = 0; i < SLAB_BATCH && pool->free_list; i++) {
+        void* object = pool->free_list;
+        pool->free_list = object_next(object);
+        pool->free_count--;
+
+        object_link(object, cache->head);
+        cache->head = object;
+        cache->count++;
+    }
+    pool->refills++;
+
+    pthread_mutex_unlock(&pool->lock);
+    return true;
+}
+
+// Move a batch of cached objects back to the shared free list
+static void slab_flush(SlabPool* pool, SlabCache* cache) {
+    pthread_mutex_lock(&pool->lock);
+
+    for (size_t i = 0; i < SLAB_BATCH && cache->head; i++) {
+        void* object = cache->head;
+        cache->head = object_next(object);
+        cache->count--;
+
+        object_link(object, pool->free_list);
+        pool->free_list = object;
+        pool->free_count++;
+    }
+    pool->flushes++;
+
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Initialize a pool of object_size objects
+bool slab_init(SlabPool* pool, size_t object_size) {
+    if (!pool || object_size == 0) return false;
+
+    memset(pool, 0, sizeof(SlabPool));
+    if (object_size < sizeof(void*)) object_size = sizeof(void*);
+    pool->object_size = (object_size + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1);
+
+    pool->slab_objects = (SLAB_BYTES - sizeof(SlabHeader)) / pool->object_size;
+    if (pool->slab_objects < SLAB_MIN_OBJECTS) pool->slab_objects = SLAB_MIN_OBJECTS;
+
+    if (pthread_key_create(&pool->key, slab_cache_retire) != 0) return false;
+    pthread_mutex_init(&pool->lock, NULL);
+    return true;
+}
+
+// Release every slab; no other thread may use the pool any more
+void slab_destroy(SlabPool* pool) {
+    if (!pool || !pool->object_size) return;
+
+    pthread_key_delete(pool->key);
+
+    while (pool->caches) {
+        SlabCache* cache = pool->caches;
+        pool->caches = cache->next;
+        free(cache);
+    }
+
+    while (pool->slabs) {
+        SlabHeader* slab = pool->slabs;
+        pool->slabs = slab->next;
+        free(slab);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    memset(pool, 0, sizeof(SlabPool));
+}
+
+// Allocate one object (uninitialized)
+void* slab_alloc(SlabPool* pool) {
+    SlabCache* cache = slab_cache(pool);
+    if (!cache) return NULL;
+
+    if (!cache->head && !slab_refill(pool, cache)) return NULL;
+
+    void* object = cache->head;
+    cache->head = object_next(object);
+    cache->count--;
+    counter_bump(&cache->allocs);
+    return object;
+}
+
+// Free one object into this thread's cache
+void slab_free(SlabPool* pool, void* object) {
+    if (!object) return;
+
+    SlabCache* cache = slab_cache(pool);
+    if (!cache) {
+        // No cache for this thread: hand the object straight back
+        pthread_mutex_lock(&pool->lock);
+        object_link(object, pool->free_list);
+        pool->free_list = object;
+        pool->free_count++;
+        pool->retired_frees++;
+        pthread_mutex_unlock(&pool->lock);
+        return;
+    }
+
+    object_link(object, cache->head);
+    cache->head = object;
+    cache->count++;
+    counter_bump(&cache->frees);
+
+    if (cache->count >= 2 * SLAB_BATCH) {
+        slab_flush(pool, cache);
+    }
+}
+
+// Snapshot pool statistics (thread counters are read without stopping them)
+void slab_stats(SlabPool* pool, SlabStats* stats) {
+    if (!pool || !stats) return;
+
+    memset(stats, 0, sizeof(SlabStats));
+    pthread_mutex_lock(&pool->lock);
+
+    stats->object_size = pool->object_size;
+    stats->slabs = pool->slab_count;
+    stats->capacity = pool->slab_count * pool->slab_objects;
+    stats->allocs = pool->retired_allocs;
+    stats->frees = pool->retired_frees;
+    stats->refills = pool->refills;
+    stats->flushes = pool->flushes;
+
+    for (SlabCache* cache = pool->caches; cache; cache = cache->next) {
+        stats->allocs += atomic_load_explicit(&cache->allocs, memory_order_relaxed);
+        stats->frees += atomic_load_explicit(&cache->frees, memory_order_relaxed);
+    }
+    stats->in_use = stats->capacity - pool->free_count;
+
+    pthread_mutex_unlock(&pool->lock);
+
+    // Objects parked in caches are free but not on the shared list
+    size_t outstanding = stats->allocs > stats->frees ? stats->allocs - stats->frees : 0;
+    stats->cached = stats->in_use > outstanding ? stats->in_use - outstanding : 0;
+    stats->in_use = outstanding;
+}
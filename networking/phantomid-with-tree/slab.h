@@ -0,0 +1,54 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+// Slab Constants
+#define SLAB_BYTES (64 * 1024)      // Bytes carved per slab
+#define SLAB_MIN_OBJECTS 8          // Objects per slab for large object sizes
+#define SLAB_BATCH 32               // Objects moved between a thread cache and the pool
+#define SLAB_ALIGN 16               // Object alignment
+
+// Allocator statistics snapshot
+typedef struct {
+    size_t object_size;             // Bytes per object (after alignment)
+    size_t slabs;                   // Slabs carved
+    size_t capacity;                // Objects carved from slabs
+    size_t in_use;                  // Objects allocated and not yet freed
+    size_t cached;                  // Free objects parked in thread caches
+    size_t allocs;                  // Allocations
+    size_t frees;                   // Frees
+    size_t refills;                 // Thread cache refills from the pool
+    size_t flushes;                 // Thread cache flushes to the pool
+} SlabStats;
+
+// Per-thread object cache
+typedef struct SlabCache SlabCache;
+
+// Fixed-size object pool with per-thread caches
+typedef struct {
+    size_t object_size;             // Bytes per object (after alignment)
+    size_t slab_objects;            // Objects per slab
+    pthread_key_t key;              // This thread's SlabCache
+    pthread_mutex_t lock;           // Guards everything below
+    void* free_list;                // Shared free objects (linked through their first word)
+    size_t free_count;              // Shared free objects
+    void* slabs;                    // Carved slabs (linked through their header)
+    size_t slab_count;              // Carved slabs
+    SlabCache* caches;              // Live thread caches
+    size_t retired_allocs;          // Counters of caches whose thread exited
+    size_t retired_frees;
+    size_t refills;                 // Cache refills
+    size_t flushes;                 // Cache flushes
+} SlabPool;
+
+// Slab Functions
+bool slab_init(SlabPool* pool, size_t object_size);
+void slab_destroy(SlabPool* pool);
+void* slab_alloc(SlabPool* pool);
+void slab_free(SlabPool* pool, void* object);
+void slab_stats(SlabPool* pool, SlabStats* stats);
+
+#endif // SLAB_H
@@ -0,0 +1,309 @@
+#include "steal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+// Deque storage, replaced whole when the owner outgrows it
+typedef struct StealArray {
+    struct StealArray* retired;     // Outgrown arrays (thieves may still read them)
+    size_t mask;                    // Slots - 1 (power of two)
+    void* _Atomic slots[];
+} StealArray;
+
+// Worker: the owner pushes and takes at the bottom, thieves take from the top
+struct StealWorker {
+    _Alignas(64) _Atomic int64_t top;   // Next item thieves take
+    _Atomic int64_t bottom;         // Next free slot (owner only writes)
+    StealArray* _Atomic array;      // Current storage
+    StealPool* pool;                // Owning pool
+    size_t index;                   // 0 is the thread inside steal_run
+    uint64_t seed;                  // Victim choice (xorshift)
+    pthread_t thread;               // Helper thread
+    bool started;                   // Thread was created
+};
+
+// Work-stealing pool: the caller of steal_run plus count - 1 helper threads
+struct StealPool {
+    StealWorker* workers;           // Worker array (workers[0] is the caller)
+    size_t count;                   // Worker count
+    pthread_mutex_t run_lock;       // One run at a time
+    pthread_mutex_t lock;           // Guards the run handoff below
+    pthread_cond_t start;           // Helpers wait here for a run
+    pthread_cond_t done;            // steal_run waits here for helpers to finish
+    uint64_t generation;            // Bumped for every run
+    size_t running;                 // Helpers still in the current run
+    bool stopping;                  // Set when the pool shuts down
+    StealTask task;                 // Current run
+    void* context;
+    _Atomic size_t pending;         // Items queued or running
+};
+
+static StealArray* steal_array_create(size_t capacity) {
+    StealArray* array = malloc(sizeof(StealArray) + capacity * sizeof(void*));
+    if (!array) return NULL;
+    array->retired = NULL;
+    array->mask = capacity - 1;
+    return array;
+}
+
+// Free a worker's outgrown arrays (no thief is running)
+static void steal_array_trim(StealWorker* worker) {
+    StealArray* array = atomic_load_explicit(&worker->array, memory_order_relaxed);
+    StealArray* retired = array->retired;
+    array->retired = NULL;
+
+    while (retired) {
+        StealArray* next = retired->retired;
+        free(retired);
+        retired = next;
+    }
+}
+
+// Double the owner's array; the old one stays readable until the run ends
+static StealArray* steal_grow(StealWorker* worker, StealArray* array, int64_t top, int64_t bottom) {
+    StealArray* grown = steal_array_create((array->mask + 1) * 2);
+    if (!grown) return NULL;
+
+    for (int64_t i = top; i < bottom; i++) {
+        void* item = atomic_load_explicit(&array->slots[i & array->mask], memory_order_relaxed);
+        atomic_store_explicit(&grown->slots[i & grown->mask], item, memory_order_relaxed);
+    }
+
+    grown->retired = array;
+    atomic_store_explicit(&worker->array, grown, memory_order_release);
+    return grown;
+}
+
+// Take the newest item from our own deque
+static void* steal_take(StealWorker* worker) {
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+    StealArray* array = atomic_load_explicit(&worker->array, memory_order_relaxed);
+    atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    void* item = atomic_load_explicit(&array->slots[bottom & array->mask], memory_order_relaxed);
+    if (top == bottom) {
+        // Last item: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            item = NULL;
+        }
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return item;
+}
+
+// Take the oldest item from another worker's deque (NULL if empty or lost a race)
+static void* steal_from(StealWorker* victim) {
+    int64_t top = atomic_load_explicit(&victim->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t bottom = atomic_load_explicit(&victim->bottom, memory_order_acquire);
+    if (top >= bottom) return NULL;
+
+    StealArray* array = atomic_load_explicit(&victim->array, memory_order_acquire);
+    void* item = atomic_load_explicit(&array->slots[top & array->mask], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&victim->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return item;
+}
+
+// Run items, our own first, until every queued item has finished
+static void steal_work(StealWorker* worker) {
+    StealPool* pool = worker->pool;
+
+    while (atomic_load(&pool->pending) > 0) {
+        void* item = steal_take(worker);
+
+        if (!item && pool->count > 1) {
+            uint64_t x = worker->seed;
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            worker->seed = x;
+
+            size_t first = (size_t)(x % pool->count);
+            for (size_t i = 0; i < pool->count && !item; i++) {
+                StealWorker* victim = &pool->workers[(first + i) % pool->count];
+                if (victim != worker) item = steal_from(victim);
+            }
+        }
+
+        if (!item) {
+            sched_yield();
+            continue;
+        }
+
+        pool->task(worker, item, pool->context);
+        atomic_fetch_sub(&pool->pending, 1);
+    }
+}
+
+static void* steal_thread_main(void* arg) {
+    StealWorker* worker = arg;
+    StealPool* pool = worker->pool;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stopping && pool->generation == seen) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stopping) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        steal_work(worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Start a pool of threads workers, the steal_run caller included
+StealPool* steal_create(size_t threads) {
+    if (threads == 0) threads = 1;
+
+    StealPool* pool = calloc(1, sizeof(StealPool));
+    if (!pool) return NULL;
+
+    pool->workers = aligned_alloc(_Alignof(StealWorker), threads * sizeof(StealWorker));
+    if (!pool->workers) {
+        free(pool);
+        return NULL;
+    }
+    memset(pool->workers, 0, threads * sizeof(StealWorker));
+
+    pthread_mutex_init(&pool->run_lock, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    atomic_init(&pool->pending, 0);
+
+    for (size_t i = 0; i < threads; i++) {
+        StealWorker* worker = &pool->workers[i];
+        atomic_init(&worker->top, 0);
+        atomic_init(&worker->bottom, 0);
+        worker->pool = pool;
+        worker->index = i;
+        worker->seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+
+        StealArray* array = steal_array_create(STEAL_DEQUE_INITIAL);
+        atomic_init(&worker->array, array);
+        pool->count = i + 1;
+        if (!array) {
+            steal_destroy(pool);
+            return NULL;
+        }
+
+        if (i > 0) {
+            if (pthread_create(&worker->thread, NULL, steal_thread_main, worker) != 0) {
+                steal_destroy(pool);
+                return NULL;
+            }
+            worker->started = true;
+        }
+    }
+
+    return pool;
+}
+
+// Stop the helper threads and free the pool (no run may be in progress)
+void steal_destroy(StealPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->count; i++) {
+        StealWorker* worker = &pool->workers[i];
+        if (worker->started) pthread_join(worker->thread, NULL);
+
+        StealArray* array = atomic_load_explicit(&worker->array, memory_order_relaxed);
+        if (array) {
+            steal_array_trim(worker);
+            free(array);
+        }
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_mutex_destroy(&pool->run_lock);
+    free(pool->workers);
+    free(pool);
+}
+
+size_t steal_thread_count(const StealPool* pool) {
+    return pool ? pool->count : 0;
+}
+
+// Run task on item and everything it pushes, spread over the pool; returns
+// once all of it has finished. Items must be non-NULL.
+void steal_run(StealPool* pool, void* item, StealTask task, void* context) {
+    if (!pool || !item || !task) return;
+
+    pthread_mutex_lock(&pool->run_lock);
+
+    pool->task = task;
+    pool->context = context;
+    steal_push(&pool->workers[0], item);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->generation++;
+    pool->running = pool->count - 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    steal_work(&pool->workers[0]);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->running > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->count; i++) {
+        steal_array_trim(&pool->workers[i]);
+    }
+
+    pthread_mutex_unlock(&pool->run_lock);
+}
+
+// Queue an item on this worker (from inside a task); if the deque cannot
+// grow the item runs right away instead
+void steal_push(StealWorker* worker, void* item) {
+    StealPool* pool = worker->pool;
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+    StealArray* array = atomic_load_explicit(&worker->array, memory_order_relaxed);
+
+    if (bottom - top > (int64_t)array->mask) {
+        array = steal_grow(worker, array, top, bottom);
+        if (!array) {
+            pool->task(worker, item, pool->context);
+            return;
+        }
+    }
+
+    atomic_fetch_add_explicit(&pool->pending, 1, memory_order_relaxed);
+    atomic_store_explicit(&array->slots[bottom & array->mask], item, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+}
+
+size_t steal_worker_index(const StealWorker* worker) {
+    return worker->index;
+}
@@ -0,0 +1,27 @@
+#ifndef STEAL_H
+#define STEAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Steal Constants
+#define STEAL_DEQUE_INITIAL 256     // Initial deque slots per worker (grows by doubling)
+
+typedef struct StealPool StealPool;
+typedef struct StealWorker StealWorker;
+
+// Runs one item on a worker; may queue more items with steal_push
+typedef void (*StealTask)(StealWorker* worker, void* item, void* context);
+
+// Steal Functions
+StealPool* steal_create(size_t threads);
+void steal_destroy(StealPool* pool);
+size_t steal_thread_count(const StealPool* pool);
+void steal_run(StealPool* pool, void* item, StealTask task, void* context);
+void steal_push(StealWorker* worker, void* item);
+size_t steal_worker_index(const StealWorker* worker);
+
+#endif // STEAL_H
@@ -0,0 +1,313 @@
+#include "tour.h"
+
+#include <limits.h>
+
+// Next treap priority (xorshift64)
+static uint32_t tour_priority(Tour* tour) {
+    uint64_t x = tour->seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    tour->seed = x;
+    return (uint32_t)(x >> 32);
+}
+
+// Recompute a token's aggregates from its children
+static void tour_update(TourToken* token) {
+    uint32_t size = 1;
+    int32_t prefix = token->weight;
+    int32_t highest = token->weight;
+    int32_t lowest = token->weight;
+
+    if (token->left) {
+        size += token->left->size;
+        prefix += token->left->sum;
+        highest = token->left->max_prefix;
+        lowest = token->left->min_prefix;
+        if (prefix > highest) highest = prefix;
+        if (prefix < lowest) lowest = prefix;
+    }
+    if (token->right) {
+        size += token->right->size;
+        if (prefix + token->right->max_prefix > highest) highest = prefix + token->right->max_prefix;
+        if (prefix + token->right->min_prefix < lowest) lowest = prefix + token->right->min_prefix;
+        prefix += token->right->sum;
+    }
+
+    token->size = size;
+    token->sum = prefix;
+    token->max_prefix = highest;
+    token->min_prefix = lowest;
+}
+
+// Concatenate two treaps (every token of a before every token of b)
+static TourToken* tour_merge(TourToken* a, TourToken* b) {
+    if (!a) return b;
+    if (!b) return a;
+
+    if (a->priority > b->priority) {
+        a->right = tour_merge(a->right, b);
+        a->right->parent = a;
+        tour_update(a);
+        return a;
+    }
+
+    b->left = tour_merge(a, b->left);
+    b->left->parent = b;
+    tour_update(b);
+    return b;
+}
+
+// Split off the first count tokens into *before, the rest into *after
+static void tour_split(TourToken* token, size_t count, TourToken** before, TourToken** after) {
+    if (!token) {
+        *before = NULL;
+        *after = NULL;
+        return;
+    }
+
+    size_t left_size = token->left ? token->left->size : 0;
+    if (count <= left_size) {
+        tour_split(token->left, count, before, &token->left);
+        if (token->left) token->left->parent = token;
+        *after = token;
+    } else {
+        tour_split(token->right, count - left_size - 1, &token->right, after);
+        if (token->right) token->right->parent = token;
+        *before = token;
+    }
+    tour_update(token);
+}
+
+// Detach a treap root from whatever it was split from
+static TourToken* tour_detach(TourToken* token) {
+    if (token) token->parent = NULL;
+    return token;
+}
+
+// Tokens and weight sum in front of a token
+static size_t tour_position(const TourToken* token, int32_t* sum_before) {
+    size_t position = token->left ? token->left->size : 0;
+    int32_t sum = token->left ? token->left->sum : 0;
+
+    for (; token->parent; token = token->parent) {
+        const TourToken* parent = token->parent;
+        if (token == parent->right) {
+            position += (parent->left ? parent->left->size : 0) + 1;
+            sum += (parent->left ? parent->left->sum : 0) + parent->weight;
+        }
+    }
+
+    if (sum_before) *sum_before = sum;
+    return position;
+}
+
+// First token of a treap
+static TourToken* tour_first(TourToken* token) {
+    while (token && token->left) token = token->left;
+    return token;
+}
+
+// Token following another in tour order
+static TourToken* tour_next(TourToken* token) {
+    if (token->right) return tour_first(token->right);
+    while (token->parent && token == token->parent->right) token = token->parent;
+    return token->parent;
+}
+
+// Last token of a subtree whose prefix is at most limit (before is the
+// prefix sum in front of the subtree; the caller knows one exists)
+static TourToken* tour_last_at_most(TourToken* token, int32_t before, int32_t limit) {
+    while (token) {
+        int32_t self = before + (token->left ? token->left->sum : 0) + token->weight;
+        if (token->right && self + token->right->min_prefix <= limit) {
+            before = self;
+            token = token->right;
+        } else if (self <= limit) {
+            return token;
+        } else {
+            token = token->left;
+        }
+    }
+    return NULL;
+}
+
+// Lowest prefix over positions [from, to) of a subtree that starts after prefix before
+static int32_t tour_range_min(const TourToken* token, size_t from, size_t to, int32_t before) {
+    if (!token || from >= to) return INT32_MAX;
+    if (from == 0 && to >= token->size) return before + token->min_prefix;
+
+    size_t left_size = token->left ? token->left->size : 0;
+    int32_t self = before + (token->left ? token->left->sum : 0) + token->weight;
+
+    int32_t lowest = tour_range_min(token->left, from, to < left_size ? to : left_size, before);
+    if (from <= left_size && left_size < to && self < lowest) lowest = self;
+
+    int32_t right = tour_range_min(token->right,
+                                   from > left_size + 1 ? from - left_size - 1 : 0,
+                                   to > left_size + 1 ? to - left_size - 1 : 0, self);
+    return right < lowest ? right : lowest;
+}
+
+// Nodes entered in front of a token
+static size_t tour_enters_before(const TourToken* token) {
+    int32_t sum;
+    size_t position = tour_position(token, &sum);
+    return (position + (size_t)sum) / 2;
+}
+
+void tour_init(Tour* tour) {
+    tour->root = NULL;
+    tour->seed = 0x9E3779B97F4A7C15ULL;
+}
+
+static void tour_token_init(Tour* tour, TourToken* token, int32_t weight) {
+    token->left = NULL;
+    token->right = NULL;
+    token->parent = NULL;
+    token->priority = tour_priority(tour);
+    token->weight = weight;
+    tour_update(token);
+}
+
+// Add a leaf as the last child of the node owning parent_exit (NULL adds a root)
+void tour_insert(Tour* tour, TourToken* parent_exit, TourToken* enter, TourToken* exit) {
+    tour_token_init(tour, enter, 1);
+    tour_token_init(tour, exit, -1);
+    tour_paste(tour, parent_exit, tour_merge(enter, exit));
+}
+
+// Paste a subtree cut with tour_cut as the last child of the node owning
+// parent_exit (NULL makes it the whole tour)
+void tour_paste(Tour* tour, TourToken* parent_exit, TourToken* subtree) {
+    TourToken* before = tour->root;
+    TourToken* after = NULL;
+    if (parent_exit) {
+        tour_split(tour->root, tour_position(parent_exit, NULL), &before, &after);
+    }
+
+    tour->root = tour_detach(tour_merge(tour_merge(tour_detach(before), subtree), tour_detach(after)));
+}
+
+// Take a node's whole subtree out of the tour; returns it as a separate
+// treap for tour_paste (or to drop)
+TourToken* tour_cut(Tour* tour, TourToken* enter, TourToken* exit) {
+    TourToken* before;
+    TourToken* inside;
+    TourToken* after;
+
+    tour_split(tour->root, tour_position(enter, NULL), &before, &inside);
+    inside = tour_detach(inside);
+    tour_split(inside, tour_position(exit, NULL) + 1, &inside, &after);
+
+    tour->root = tour_detach(tour_merge(tour_detach(before), tour_detach(after)));
+    return tour_detach(inside);
+}
+
+// Whether a token is still in the tour (not in a cut-off subtree)
+bool tour_member(const Tour* tour, const TourToken* token) {
+    while (token->parent) token = token->parent;
+    return token == tour->root;
+}
+
+// Remove a node's tokens; its descendants move up to its parent
+void tour_remove(Tour* tour, TourToken* enter, TourToken* exit) {
+    TourToken* before;
+    TourToken* rest;
+    TourToken* dropped;
+    TourToken* inside;
+    TourToken* after;
+
+    // Positions are taken after each detach, inside the piece holding the token
+    tour_split(tour->root, tour_position(enter, NULL), &before, &rest);
+    rest = tour_detach(rest);
+    tour_split(rest, 1, &dropped, &rest);
+    rest = tour_detach(rest);
+    tour_split(rest, tour_position(exit, NULL), &inside, &rest);
+    rest = tour_detach(rest);
+    tour_split(rest, 1, &dropped, &after);
+
+    tour->root = tour_detach(tour_merge(tour_detach(before),
+                                        tour_merge(tour_detach(inside), tour_detach(after))));
+}
+
+// Nodes in a subtree, its root included
+size_t tour_subtree_size(const TourToken* enter, const TourToken* exit) {
+    return tour_enters_before(exit) - tour_enters_before(enter);
+}
+
+// Distance from the tree root (0 for the root)
+size_t tour_depth(const TourToken* enter) {
+    int32_t sum;
+    tour_position(enter, &sum);
+    return (size_t)sum;
+}
+
+// Levels in the tree (0 when empty)
+size_t tour_height(const Tour* tour) {
+    return tour->root ? (size_t)tour->root->max_prefix : 0;
+}
+
+// Position of a token in tour order
+size_t tour_index(const TourToken* token) {
+    return tour_position(token, NULL);
+}
+
+// Enter token of the ancestor at depth (at most the node's own depth; the
+// node itself at its own depth). That ancestor's enter is the token right
+// after the last token before enter whose prefix is at most depth.
+TourToken* tour_ancestor(const Tour* tour, TourToken* enter, size_t depth) {
+    int32_t limit = (int32_t)depth;
+    int32_t after;
+    tour_position(enter, &after);
+
+    // Search the pieces in front of enter, nearest first: its left subtree,
+    // then every treap ancestor it hangs right of, with that ancestor's left
+    TourToken* found = NULL;
+    TourToken* left = enter->left;
+    if (left && after - left->sum + left->min_prefix <= limit) {
+        found = tour_last_at_most(left, after - left->sum, limit);
+    } else {
+        if (left) after -= left->sum;
+
+        for (TourToken* token = enter; token->parent; token = token->parent) {
+            TourToken* parent = token->parent;
+            if (token != parent->right) continue;
+
+            if (after <= limit) {
+                found = parent;
+                break;
+            }
+            after -= parent->weight;
+
+            if (parent->left) {
+                int32_t before = after - parent->left->sum;
+                if (before + parent->left->min_prefix <= limit) {
+                    found = tour_last_at_most(parent->left, before, limit);
+                    break;
+                }
+                after = before;
+            }
+        }
+    }
+
+    return found ? tour_next(found) : tour_first(tour->root);
+}
+
+// Enter token of the lowest common ancestor of two nodes: one level above
+// the lowest prefix between their enter tokens
+TourToken* tour_lca(const Tour* tour, TourToken* first, TourToken* second) {
+    size_t from = tour_index(first);
+    size_t to = tour_index(second);
+    if (from > to) {
+        TourToken* swap = first;
+        first = second;
+        second = swap;
+        size_t index = from;
+        from = to;
+        to = index;
+    }
+
+    int32_t lowest = tour_range_min(tour->root, from, to + 1, 0);
+    return tour_ancestor(tour, second, (size_t)(lowest - 1));
+}
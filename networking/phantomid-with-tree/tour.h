@@ -0,0 +1,43 @@
+#ifndef TOUR_H
+#define TOUR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Euler-tour token: every tree node owns an enter (+1) and an exit (-1)
+// token, kept in depth-first order in a treap. A node's subtree is the
+// run between its two tokens; its depth is the weight sum up to its enter.
+typedef struct TourToken {
+    struct TourToken* left;         // Treap children
+    struct TourToken* right;
+    struct TourToken* parent;       // Treap parent (NULL at the treap root)
+    uint32_t priority;              // Heap order of the treap
+    int32_t weight;                 // +1 enter, -1 exit
+    uint32_t size;                  // Tokens in this treap subtree
+    int32_t sum;                    // Weight sum of this treap subtree
+    int32_t max_prefix;             // Highest prefix sum inside this treap subtree
+    int32_t min_prefix;             // Lowest prefix sum inside this treap subtree
+} TourToken;
+
+// Euler tour of one tree (callers serialize all access)
+typedef struct {
+    TourToken* root;                // Treap root
+    uint64_t seed;                  // Priority generator state (xorshift)
+} Tour;
+
+// Tour Functions
+void tour_init(Tour* tour);
+void tour_insert(Tour* tour, TourToken* parent_exit, TourToken* enter, TourToken* exit);
+void tour_remove(Tour* tour, TourToken* enter, TourToken* exit);
+TourToken* tour_cut(Tour* tour, TourToken* enter, TourToken* exit);
+void tour_paste(Tour* tour, TourToken* parent_exit, TourToken* subtree);
+bool tour_member(const Tour* tour, const TourToken* token);
+size_t tour_subtree_size(const TourToken* enter, const TourToken* exit);
+size_t tour_depth(const TourToken* enter);
+size_t tour_height(const Tour* tour);
+size_t tour_index(const TourToken* token);
+TourToken* tour_ancestor(const Tour* tour, TourToken* enter, size_t depth);
+TourToken* tour_lca(const Tour* tour, TourToken* first, TourToken* second);
+
+#endif // TOUR_H